@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/async_queue.hpp"
+#include "ymcqueue/executor.hpp"
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+/** An element carrying the time it was enqueued at. */
+struct stamped_t {
+  clock_type::time_point enqueued{};
+};
+
+/** A fire-and-forget coroutine, which runs eagerly and destroys itself on completion. */
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+using queue_type = ymc::async_queue<stamped_t>;
+
+double nanos_since(clock_type::time_point since) {
+  return static_cast<double>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - since).count());
+}
+
+/** Awaits `samples` elements and records their wake-up latencies. */
+detached_task await_samples(
+    queue_type& queue,
+    ymc::single_thread_executor& executor,
+    std::size_t samples,
+    std::vector<double>& latencies,
+    std::atomic_size_t& received
+) {
+  for (std::size_t i = 0; i < samples; ++i) {
+    auto elem = co_await queue.async_dequeue(1, executor);
+    latencies.push_back(nanos_since(elem->enqueued));
+    received.fetch_add(1, std::memory_order_release);
+  }
+
+  executor.stop();
+}
+
+/**
+ * Sends `samples` time-stamped elements one at a time to a consumer, which either awaits them in
+ * a coroutine or polls the queue in a loop, and returns the latencies between each enqueue and
+ * the consumer receiving the element.
+ */
+std::vector<double> run_once(bool coroutine, std::size_t samples, const bench::options_t& opts) {
+  queue_type queue{ 2 };
+  std::vector<stamped_t> elements(samples);
+  std::vector<double> latencies{};
+  latencies.reserve(samples);
+  std::atomic_size_t received{ 0 };
+
+  std::thread consumer{ [&] {
+    if (opts.pin) {
+      bench::pin_thread(1);
+    }
+
+    if (coroutine) {
+      ymc::single_thread_executor executor{};
+      await_samples(queue, executor, samples, latencies, received);
+      executor.run();
+    } else {
+      for (std::size_t i = 0; i < samples; ++i) {
+        stamped_t* elem = nullptr;
+        while ((elem = queue.dequeue(1)) == nullptr) {}
+        latencies.push_back(nanos_since(elem->enqueued));
+        received.fetch_add(1, std::memory_order_release);
+      }
+    }
+  } };
+
+  if (opts.pin) {
+    bench::pin_thread(0);
+  }
+
+  for (std::size_t i = 0; i < samples; ++i) {
+    // give the consumer time to suspend (or start polling) again before the next element
+    const auto pause = clock_type::now() + std::chrono::microseconds(20);
+    while (clock_type::now() < pause) {}
+
+    elements[i].enqueued = clock_type::now();
+    queue.enqueue(&elements[i], 0);
+    while (received.load(std::memory_order_acquire) <= i) {
+      std::this_thread::yield();
+    }
+  }
+
+  consumer.join();
+  return latencies;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  const auto idx = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[idx];
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{ opts.csv, "consumer,run,samples,mean_ns,p50_ns,p99_ns,max_ns" };
+
+  // every sample pauses the producer, so fewer samples than operations in other benchmarks
+  const auto samples = std::max<std::size_t>(1, std::min<std::size_t>(opts.ops, 100 * 1000));
+  for (const auto coroutine : { true, false }) {
+    for (std::size_t run = 0; run < opts.runs; ++run) {
+      auto latencies = run_once(coroutine, samples, opts);
+      std::sort(latencies.begin(), latencies.end());
+      const auto s = bench::summary_t::of(latencies);
+      csv.row(
+          coroutine ? "coroutine" : "spin_poll",
+          run,
+          samples,
+          s.mean,
+          percentile(latencies, 0.5),
+          percentile(latencies, 0.99),
+          latencies.back()
+      );
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+template <typename Backoff>
+using backoff_queue = ymc::basic_queue<
+    int, 1024, 10, 128, ymc::padded_cells, ymc::hazard_reclaim, ymc::mpmc, Backoff
+>;
+
+/** The result of a single run. */
+struct run_result_t {
+  double elapsed;
+  ymc::queue_stats stats;
+};
+
+/**
+ * Runs pairwise enqueue/dequeue operations (`random == false`) or a random mix of both, which
+ * lets dequeuers race ahead of producers and poison cells.
+ */
+template <typename Q>
+run_result_t run_once(bool random, std::size_t threads, const bench::options_t& opts, bench::element_pool& pool) {
+  Q queue{ threads };
+  const auto elapsed = bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    bench::xorshift rng{ t };
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      if (random ? (rng.next() & 1) == 0 : op % 2 == 0) {
+        queue.enqueue(pool.get(op), t);
+      } else {
+        volatile auto res = queue.dequeue(t);
+        (void) res;
+      }
+    }
+  });
+
+  return { elapsed, queue.stats() };
+}
+
+template <typename Backoff>
+void run_policy(std::string_view policy, const bench::options_t& opts, bench::csv_writer& csv) {
+  bench::element_pool pool{ 1024 };
+
+  for (const auto random : { false, true }) {
+    for (auto threads : opts.thread_counts()) {
+      std::vector<double> ops_per_sec{};
+      std::vector<double> burned_per_op{};
+      std::vector<double> slow_enq{};
+      std::vector<double> slow_deq{};
+
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        const auto res = run_once<backoff_queue<Backoff>>(random, threads, opts, pool);
+        const auto total = static_cast<double>(threads * opts.ops);
+        const auto& s = res.stats;
+        const auto enqueues = static_cast<double>(s.fast_enqueues + s.slow_enqueues);
+        const auto dequeues = static_cast<double>(s.fast_dequeues + s.slow_dequeues);
+
+        ops_per_sec.push_back(total / (res.elapsed / 1e9));
+        burned_per_op.push_back(static_cast<double>(s.cells_burned) / total);
+        slow_enq.push_back(enqueues == 0 ? 0.0 : static_cast<double>(s.slow_enqueues) / enqueues);
+        slow_deq.push_back(dequeues == 0 ? 0.0 : static_cast<double>(s.slow_dequeues) / dequeues);
+      }
+
+      const auto ops = bench::summary_t::of(ops_per_sec);
+      csv.row(
+          policy,
+          random ? "random" : "pairwise",
+          threads,
+          ops.mean,
+          ops.stddev,
+          bench::summary_t::of(burned_per_op).mean,
+          bench::summary_t::of(slow_enq).mean,
+          bench::summary_t::of(slow_deq).mean
+      );
+    }
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  if (!ymc::queue_stats{}.enabled) {
+    std::cerr << "cell and slow-path counts require building with -DYMC_QUEUE_STATS=ON" << std::endl;
+    return 1;
+  }
+
+  bench::csv_writer csv{
+    opts.csv,
+    "backoff,workload,threads,ops_per_sec,ops_per_sec_stddev,cells_burned_per_op,slow_enqueue_ratio,slow_dequeue_ratio"
+  };
+
+  run_policy<ymc::no_backoff>("none", opts, csv);
+  run_policy<ymc::fixed_backoff<100>>("fixed_100", opts, csv);
+  run_policy<ymc::adaptive_backoff<100>>("adaptive_100", opts, csv);
+  run_policy<ymc::adaptive_backoff<1000>>("adaptive_1000", opts, csv);
+}
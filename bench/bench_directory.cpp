@@ -0,0 +1,90 @@
+#include <chrono>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/orig.hpp"
+#include "ymcqueue/queue.hpp"
+
+namespace {
+/** The number of rounds, after each of which the lagging handle performs one operation pair. */
+constexpr std::size_t ROUNDS = 256;
+
+double elapsed_ns(std::chrono::steady_clock::time_point begin) {
+  const auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+/**
+ * Fills the queue with a backlog of `backlog` elements, then runs rounds of pairwise operations
+ * on an active handle, after each of which an otherwise idle handle enqueues and dequeues one
+ * element.
+ *
+ * Cleanup advances the idle handle's pointers to the dequeue front only, so each of its enqueues
+ * has to locate the enqueue front `backlog` elements ahead, which requires walking the list
+ * without a node directory. Returns the latencies of the idle handle's enqueues and the
+ * throughput of the active handle.
+ */
+template <typename Q>
+std::pair<std::vector<double>, double> run_once(std::size_t backlog, const bench::options_t& opts, bench::element_pool& pool) {
+  Q queue{ 2 };
+  for (std::size_t i = 0; i < backlog; ++i) {
+    queue.enqueue(pool.get(i), 0);
+  }
+
+  const auto ops_per_round = std::max<std::size_t>(opts.ops / ROUNDS, 1);
+  std::vector<double> lagging{};
+  double active = 0.0;
+
+  for (std::size_t round = 0; round < ROUNDS; ++round) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t op = 0; op < ops_per_round; ++op) {
+      queue.enqueue(pool.get(op), 0);
+      volatile auto res = queue.dequeue(0);
+      (void) res;
+    }
+    active += elapsed_ns(begin);
+
+    const auto lag_begin = std::chrono::steady_clock::now();
+    queue.enqueue(pool.get(round), 1);
+    lagging.push_back(elapsed_ns(lag_begin));
+
+    volatile auto res = queue.dequeue(1);
+    (void) res;
+  }
+
+  const auto ops = static_cast<double>(2 * ROUNDS * ops_per_round);
+  return { lagging, ops / (active / 1e9) };
+}
+
+template <typename Q>
+void run_engine(std::string_view engine, const bench::options_t& opts, bench::csv_writer& csv) {
+  bench::element_pool pool{ 1024 };
+
+  for (std::size_t backlog : { 0, 64 * 1024, 256 * 1024, 1024 * 1024 }) {
+    std::vector<double> lagging{};
+    std::vector<double> ops_per_sec{};
+
+    for (std::size_t run = 0; run < opts.runs; ++run) {
+      auto [latencies, ops] = run_once<Q>(backlog, opts, pool);
+      lagging.insert(lagging.end(), latencies.begin(), latencies.end());
+      ops_per_sec.push_back(ops);
+    }
+
+    const auto lag = bench::summary_t::of(lagging);
+    const auto ops = bench::summary_t::of(ops_per_sec);
+    csv.row(engine, backlog, lag.mean, lag.stddev, ops.mean, ops.stddev);
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    "queue,backlog,lagging_enqueue_ns,lagging_enqueue_ns_stddev,ops_per_sec,ops_per_sec_stddev"
+  };
+
+  run_engine<ymc::queue<int>>("ymc", opts, csv);
+  run_engine<ymc_original::queue<int>>("ymc_original", opts, csv);
+}
@@ -0,0 +1,60 @@
+#include <unistd.h>
+
+#include <memory>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+/** A queue type admitting the largest benchmarked number of thread handles. */
+using queue_type = ymc::basic_queue<int, ymc::detail::NODE_SIZE, ymc::detail::PATIENCE, 1024>;
+
+/** The number of queues constructed at once for measuring their resident memory. */
+constexpr std::size_t QUEUES = 16;
+
+/** Returns the resident set size of the process in bytes. */
+std::size_t resident_bytes() {
+  std::ifstream statm{ "/proc/self/statm" };
+  std::size_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Reports the per-queue footprint with `max_threads` handles right after construction, both as
+ * reported by `memory_footprint` and as measured by the growth of the resident set size, and once
+ * `used` handles have each completed an enqueue and a dequeue.
+ */
+void run_once(std::size_t max_threads, std::size_t used, bench::element_pool& pool, bench::csv_writer& csv) {
+  std::vector<std::unique_ptr<queue_type>> queues{};
+  const auto rss_before = resident_bytes();
+  for (std::size_t i = 0; i < QUEUES; ++i) {
+    queues.push_back(std::make_unique<queue_type>(max_threads));
+  }
+  const auto rss_after = resident_bytes();
+  const auto rss = rss_after > rss_before ? (rss_after - rss_before) / QUEUES : 0;
+
+  auto& queue = *queues.front();
+  const auto fresh = queue.memory_footprint();
+  for (std::size_t t = 0; t < used; ++t) {
+    queue.enqueue(pool.get(t), t);
+    volatile auto res = queue.dequeue(t);
+    (void) res;
+  }
+
+  csv.row(max_threads, used, fresh, rss, queue.memory_footprint());
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{ opts.csv, "max_threads,used_handles,fresh_bytes,fresh_rss_bytes,used_bytes" };
+  bench::element_pool pool{ 1024 };
+
+  for (const std::size_t max_threads : { 8, 128, 1024 }) {
+    for (std::size_t run = 0; run < opts.runs; ++run) {
+      run_once(max_threads, std::min(max_threads, opts.max_threads), pool, csv);
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#include <atomic>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+/** How idle consumers poll the queue. */
+enum class poll_t { dequeue, try_dequeue };
+
+/**
+ * Runs a single thread alternating `opts.ops` enqueues and dequeues, while all remaining threads
+ * poll the queue as idle consumers, and returns the elapsed time of the active thread and the
+ * number of nodes acquired for the queue.
+ */
+std::pair<double, std::size_t> run_once(poll_t poll, std::size_t threads, const bench::options_t& opts, bench::element_pool& pool) {
+  ymc::queue<int> queue{ threads };
+  std::atomic_bool done{ false };
+  double elapsed = 0.0;
+
+  bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    if (t == 0) {
+      const auto begin = std::chrono::steady_clock::now();
+      for (std::size_t op = 0; op < opts.ops; ++op) {
+        queue.enqueue(pool.get(op), t);
+        volatile auto res = queue.dequeue(t);
+        (void) res;
+      }
+
+      const auto end = std::chrono::steady_clock::now();
+      elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+      done.store(true);
+    } else {
+      while (!done.load(std::memory_order_relaxed)) {
+        volatile auto res = poll == poll_t::dequeue ? queue.dequeue(t) : queue.try_dequeue(t);
+        (void) res;
+      }
+    }
+  });
+
+  const auto stats = queue.pool_stats();
+  return { elapsed, stats.hits + stats.misses };
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    "poll,threads,idle_consumers,ops_per_sec,ops_per_sec_stddev,nodes_acquired,node_bytes_acquired"
+  };
+
+  bench::element_pool pool{ 1024 };
+  for (const auto poll : { poll_t::dequeue, poll_t::try_dequeue }) {
+    const std::string_view name = poll == poll_t::dequeue ? "dequeue" : "try_dequeue";
+    for (auto threads : opts.thread_counts()) {
+      std::vector<double> ops_per_sec{};
+      std::size_t nodes = 0;
+
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        const auto [elapsed, acquired] = run_once(poll, threads, opts, pool);
+        ops_per_sec.push_back(static_cast<double>(2 * opts.ops) / (elapsed / 1e9));
+        nodes += acquired;
+      }
+
+      nodes /= opts.runs;
+      const auto ops = bench::summary_t::of(ops_per_sec);
+      const auto node_bytes = nodes * ymc::queue<int>::NODE_BYTES;
+      csv.row(name, threads, threads - 1, ops.mean, ops.stddev, nodes, node_bytes);
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+/**
+ * Runs pairwise enqueue/dequeue operations and reports the latency percentiles (in timestamp
+ * counter ticks) of fast-path and slow-path completions next to the slow-path frequency, either
+ * with or without a background node preparer.
+ */
+void run_once(bool prepared, std::size_t threads, const bench::options_t& opts, bench::element_pool& pool, bench::csv_writer& csv) {
+  ymc::queue<int> queue{ threads, threads * 16 };
+  if (prepared) {
+    queue.start_node_preparer(threads * 8);
+  }
+
+  bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      if (op % 2 == 0) {
+        queue.enqueue(pool.get(op), t);
+      } else {
+        volatile auto res = queue.dequeue(t);
+        (void) res;
+      }
+    }
+  });
+
+  const auto latencies = queue.latencies();
+  const auto row = [&](std::string_view path, const ymc::latency_histogram& histogram) {
+    const auto s = histogram.summary();
+    csv.row(path, prepared, threads, s.count, s.p50, s.p99, s.p999, s.max);
+  };
+
+  row("fast_enqueue", latencies.fast_enqueue);
+  row("slow_enqueue", latencies.slow_enqueue);
+  row("fast_dequeue", latencies.fast_dequeue);
+  row("slow_dequeue", latencies.slow_dequeue);
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  if (!ymc::queue_latencies{}.enabled) {
+    std::cerr << "latency histograms require building with -DYMC_QUEUE_LATENCY=ON" << std::endl;
+    return 1;
+  }
+
+  bench::csv_writer csv{ opts.csv, "path,preparer,threads,count,p50,p99,p999,max" };
+  bench::element_pool pool{ 1024 };
+
+  for (const auto prepared : { false, true }) {
+    for (auto threads : opts.thread_counts()) {
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        run_once(prepared, threads, opts, pool, csv);
+      }
+    }
+  }
+}
@@ -0,0 +1,83 @@
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+template <typename Layout>
+using layout_queue = ymc::basic_queue<int, 1024, 10, 128, Layout>;
+
+/**
+ * Runs pairwise enqueue/dequeue operations and bursts of `burst` enqueues followed by as many
+ * dequeues, which make consecutive tickets hit consecutive cells.
+ */
+template <typename Q>
+double run_once(
+    std::size_t burst,
+    std::size_t threads,
+    const bench::options_t& opts,
+    bench::element_pool& pool,
+    bench::perf_totals_t* perf
+) {
+  Q queue{ threads };
+  return bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      if (op % (2 * burst) < burst) {
+        queue.enqueue(pool.get(op), t);
+      } else {
+        volatile auto res = queue.dequeue(t);
+        (void) res;
+      }
+    }
+  }, perf);
+}
+
+template <typename Layout>
+void run_layout(std::string_view layout, const bench::options_t& opts, bench::csv_writer& csv) {
+  using queue_type = layout_queue<Layout>;
+
+  bench::element_pool pool{ 1024 };
+  const auto bytes_per_element = static_cast<double>(queue_type::NODE_BYTES) / 1024.0;
+
+  for (std::size_t burst : { 1, 64 }) {
+    for (auto threads : opts.thread_counts()) {
+      std::vector<double> ops_per_sec{};
+      std::vector<double> ns_per_op{};
+      std::vector<std::array<double, bench::PERF_EVENTS>> events_per_op{};
+
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        bench::perf_totals_t perf{ opts.rfo_event };
+        const auto elapsed = run_once<queue_type>(burst, threads, opts, pool, opts.perf ? &perf : nullptr);
+        const auto total = static_cast<double>(threads * opts.ops);
+        ops_per_sec.push_back(total / (elapsed / 1e9));
+        ns_per_op.push_back(elapsed * static_cast<double>(threads) / total);
+        events_per_op.push_back(perf.per_op(total));
+      }
+
+      const auto ops = bench::summary_t::of(ops_per_sec);
+      const auto ns = bench::summary_t::of(ns_per_op);
+      if (opts.perf) {
+        const auto events = bench::perf_columns_t::of(events_per_op);
+        csv.row(layout, burst, threads, bytes_per_element, ops.mean, ops.stddev, ns.mean, ns.stddev, events);
+      } else {
+        csv.row(layout, burst, threads, bytes_per_element, ops.mean, ops.stddev, ns.mean, ns.stddev);
+      }
+    }
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    bench::csv_header(
+        "layout,burst,threads,bytes_per_element,ops_per_sec,ops_per_sec_stddev,ns_per_op,ns_per_op_stddev",
+        opts)
+  };
+
+  run_layout<ymc::padded_cells>("padded", opts, csv);
+  run_layout<ymc::split_cells>("split", opts, csv);
+  run_layout<ymc::dense_cells>("dense", opts, csv);
+}
@@ -0,0 +1,70 @@
+#include <atomic>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+template <typename Mode>
+using mode_queue = ymc::basic_queue<int, 1024, 10, 128, ymc::padded_cells, ymc::hazard_reclaim, Mode>;
+
+/**
+ * Runs `producers` threads enqueueing `opts.ops` elements each and `consumers` threads dequeueing
+ * until all elements have been consumed, returns the elapsed time.
+ */
+template <typename Mode>
+double run_once(std::size_t producers, std::size_t consumers, const bench::options_t& opts, bench::element_pool& pool) {
+  mode_queue<Mode> queue{ producers + consumers };
+  std::atomic_size_t dequeued{ 0 };
+  const auto total = producers * opts.ops;
+
+  return bench::run_threads(producers + consumers, opts.pin, [&](std::size_t t) {
+    if (t < producers) {
+      for (std::size_t op = 0; op < opts.ops; ++op) {
+        queue.enqueue(pool.get(op), t);
+      }
+    } else {
+      while (dequeued.load(std::memory_order_relaxed) < total) {
+        if (queue.dequeue(t) != nullptr) {
+          dequeued.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+}
+
+template <typename Mode>
+void run_mode(std::string_view mode, std::size_t producers, std::size_t consumers, const bench::options_t& opts, bench::csv_writer& csv) {
+  bench::element_pool pool{ 1024 };
+  std::vector<double> ops_per_sec{};
+
+  for (std::size_t run = 0; run < opts.runs; ++run) {
+    const auto elapsed = run_once<Mode>(producers, consumers, opts, pool);
+    ops_per_sec.push_back(static_cast<double>(producers * opts.ops) / (elapsed / 1e9));
+  }
+
+  const auto ops = bench::summary_t::of(ops_per_sec);
+  csv.row(mode, producers, consumers, ops.mean, ops.stddev);
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{ opts.csv, "mode,producers,consumers,elements_per_sec,elements_per_sec_stddev" };
+
+  // every specialized mode is compared against the general mode with the same thread roles
+  run_mode<ymc::spsc>("spsc", 1, 1, opts, csv);
+  run_mode<ymc::mpmc>("mpmc", 1, 1, opts, csv);
+
+  for (auto threads : opts.thread_counts()) {
+    if (threads < 3) {
+      continue;
+    }
+
+    run_mode<ymc::mpsc>("mpsc", threads - 1, 1, opts, csv);
+    run_mode<ymc::mpmc>("mpmc", threads - 1, 1, opts, csv);
+    run_mode<ymc::spmc>("spmc", 1, threads - 1, opts, csv);
+    run_mode<ymc::mpmc>("mpmc", 1, threads - 1, opts, csv);
+  }
+}
@@ -0,0 +1,80 @@
+#include <array>
+#include <memory>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/priority_queue.hpp"
+
+namespace {
+constexpr std::size_t LEVELS = 8;
+
+/** The caller-side alternative: one queue per level, scanned in order by every dequeue. */
+struct naive_priority_queue {
+  std::array<std::unique_ptr<ymc::queue<int>>, LEVELS> lanes;
+
+  explicit naive_priority_queue(std::size_t max_threads) {
+    for (auto& lane : this->lanes) {
+      lane = std::make_unique<ymc::queue<int>>(max_threads);
+    }
+  }
+
+  void enqueue(int* elem, std::size_t level, std::size_t thread_id) {
+    this->lanes[level]->enqueue(elem, thread_id);
+  }
+
+  int* dequeue(std::size_t thread_id) {
+    for (auto& lane : this->lanes) {
+      if (auto res = lane->dequeue(thread_id); res != nullptr) {
+        return res;
+      }
+    }
+
+    return nullptr;
+  }
+};
+
+/**
+ * Runs pairwise enqueue/dequeue operations, where elements are enqueued into the lowest lane only
+ * (`spread == false`), which makes every scan pass all empty lanes, or into random lanes.
+ */
+template <typename Q>
+double run_once(bool spread, std::size_t threads, const bench::options_t& opts, bench::element_pool& pool) {
+  Q queue{ threads };
+  return bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    bench::xorshift rng{ t };
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      const auto level = spread ? rng.next() % LEVELS : LEVELS - 1;
+      queue.enqueue(pool.get(op), level, t);
+      volatile auto res = queue.dequeue(t);
+      (void) res;
+    }
+  });
+}
+
+template <typename Q>
+void run_queue(std::string_view name, const bench::options_t& opts, bench::csv_writer& csv) {
+  bench::element_pool pool{ 1024 };
+
+  for (const auto spread : { false, true }) {
+    for (auto threads : opts.thread_counts()) {
+      std::vector<double> ops_per_sec{};
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        const auto elapsed = run_once<Q>(spread, threads, opts, pool);
+        ops_per_sec.push_back(static_cast<double>(2 * threads * opts.ops) / (elapsed / 1e9));
+      }
+
+      const auto ops = bench::summary_t::of(ops_per_sec);
+      csv.row(name, spread ? "random_level" : "lowest_level", threads, ops.mean, ops.stddev);
+    }
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{ opts.csv, "queue,levels,threads,ops_per_sec,ops_per_sec_stddev" };
+
+  run_queue<ymc::priority_queue<int, LEVELS>>("priority_queue", opts, csv);
+  run_queue<naive_priority_queue>("naive_scan", opts, csv);
+}
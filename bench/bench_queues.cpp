@@ -0,0 +1,160 @@
+#include <functional>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/orig.hpp"
+#include "ymcqueue/queue.hpp"
+#include "ymcqueue/sharded_queue.hpp"
+
+namespace {
+/** The workloads each queue engine is run through. */
+enum class workload_t { pairwise, random, producer_heavy, consumer_heavy, empty_poll };
+
+constexpr workload_t WORKLOADS[] = {
+  workload_t::pairwise,
+  workload_t::random,
+  workload_t::producer_heavy,
+  workload_t::consumer_heavy,
+  workload_t::empty_poll,
+};
+
+std::string_view name_of(workload_t workload) {
+  switch (workload) {
+    case workload_t::pairwise:       return "pairwise";
+    case workload_t::random:         return "random";
+    case workload_t::producer_heavy: return "producer_heavy";
+    case workload_t::consumer_heavy: return "consumer_heavy";
+    case workload_t::empty_poll:     return "empty_poll";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Returns whether the operation `op` of thread `t` is an enqueue.
+ *
+ * The heavy workloads assign a quarter of all threads to the minority role, a single thread
+ * interleaves both roles at the same 3:1 ratio instead.
+ */
+bool is_enqueue(workload_t workload, std::size_t t, std::size_t threads, std::size_t op, bench::xorshift& rng) {
+  switch (workload) {
+    case workload_t::pairwise:
+      return op % 2 == 0;
+    case workload_t::random:
+      return (rng.next() & 1) == 0;
+    case workload_t::producer_heavy:
+      return threads == 1 ? op % 4 != 3 : t % 4 != 3;
+    case workload_t::consumer_heavy:
+      return threads == 1 ? op % 4 == 3 : t % 4 == 3;
+    case workload_t::empty_poll:
+      return false;
+  }
+
+  return false;
+}
+
+/** A `ymc::queue` allocating its nodes from the huge page arena. */
+template <typename T>
+struct huge_page_queue : ymc::queue<T> {
+  explicit huge_page_queue(std::size_t max_threads) :
+    ymc::queue<T>{ max_threads, max_threads * 2, ymc::node_memory::huge_pages } {}
+};
+
+/**
+ * A `ymc::queue` whose operations are never inlined into the caller, emulating the former
+ * out-of-line engine behind a translation unit boundary.
+ */
+template <typename T>
+struct out_of_line_queue : ymc::queue<T> {
+  using ymc::queue<T>::queue;
+
+  [[gnu::noinline]] void enqueue(T* elem, std::size_t thread_id) {
+    ymc::queue<T>::enqueue(elem, thread_id);
+  }
+
+  [[gnu::noinline]] T* dequeue(std::size_t thread_id) {
+    return ymc::queue<T>::dequeue(thread_id);
+  }
+};
+
+/** A queue with a node size that is no power of two, so cells are located by division. */
+template <typename T>
+using non_pow2_queue = ymc::basic_queue<T, 1000>;
+
+/** A sharded queue with four shards per NUMA node. */
+template <typename T>
+struct four_shard_queue : ymc::sharded_queue<T> {
+  explicit four_shard_queue(std::size_t max_threads) : ymc::sharded_queue<T>{ max_threads, 4 } {}
+};
+
+template <typename Q>
+double run_once(
+    workload_t workload,
+    std::size_t threads,
+    const bench::options_t& opts,
+    bench::element_pool& pool,
+    bench::perf_totals_t* perf
+) {
+  Q queue{ threads };
+  return bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    bench::xorshift rng{ t };
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      if (is_enqueue(workload, t, threads, op, rng)) {
+        queue.enqueue(pool.get(op), t);
+      } else {
+        volatile auto res = queue.dequeue(t);
+        (void) res;
+      }
+    }
+  }, perf);
+}
+
+template <typename Q>
+void run_engine(std::string_view engine, const bench::options_t& opts, bench::csv_writer& csv) {
+  bench::element_pool pool{ 1024 };
+
+  for (auto workload : WORKLOADS) {
+    for (auto threads : opts.thread_counts()) {
+      std::vector<double> ops_per_sec{};
+      std::vector<double> ns_per_op{};
+      std::vector<std::array<double, bench::PERF_EVENTS>> events_per_op{};
+
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        bench::perf_totals_t perf{ opts.rfo_event };
+        const auto elapsed = run_once<Q>(workload, threads, opts, pool, opts.perf ? &perf : nullptr);
+        const auto total = static_cast<double>(threads * opts.ops);
+        ops_per_sec.push_back(total / (elapsed / 1e9));
+        ns_per_op.push_back(elapsed * static_cast<double>(threads) / total);
+        events_per_op.push_back(perf.per_op(total));
+      }
+
+      const auto ops = bench::summary_t::of(ops_per_sec);
+      const auto ns = bench::summary_t::of(ns_per_op);
+      if (opts.perf) {
+        const auto events = bench::perf_columns_t::of(events_per_op);
+        csv.row(engine, name_of(workload), threads, ops.mean, ops.stddev, ns.mean, ns.stddev, events);
+      } else {
+        csv.row(engine, name_of(workload), threads, ops.mean, ops.stddev, ns.mean, ns.stddev);
+      }
+    }
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    bench::csv_header(
+        "queue,workload,threads,ops_per_sec,ops_per_sec_stddev,ns_per_op,ns_per_op_stddev", opts)
+  };
+
+  run_engine<ymc::queue<int>>("ymc", opts, csv);
+  run_engine<out_of_line_queue<int>>("ymc_out_of_line", opts, csv);
+  run_engine<non_pow2_queue<int>>("ymc_node_1000", opts, csv);
+  run_engine<huge_page_queue<int>>("ymc_huge_pages", opts, csv);
+  run_engine<ymc::sharded_queue<int>>("ymc_sharded", opts, csv);
+  run_engine<four_shard_queue<int>>("ymc_sharded_4", opts, csv);
+  run_engine<ymc_original::queue<int>>("ymc_original", opts, csv);
+}
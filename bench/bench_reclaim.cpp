@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <thread>
+
+#include "common.hpp"
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+template <typename Reclaim>
+using reclaim_queue = ymc::basic_queue<int, 1024, 10, 128, ymc::padded_cells, Reclaim>;
+
+/** The result of a single run. */
+struct run_result_t {
+  double elapsed;
+  /** Mean and peak of the node memory held by the queue, including its node pool. */
+  double mean_bytes;
+  std::size_t peak_bytes;
+};
+
+/** Returns the bytes of all nodes currently held by the queue and its node pool. */
+template <typename Q>
+std::size_t held_bytes(const Q& queue) {
+  return queue.stats().node_bytes + queue.pool_stats().size * Q::NODE_BYTES;
+}
+
+/**
+ * Runs pairwise enqueue/dequeue operations while a sampler thread periodically records the node
+ * memory held by the queue.
+ */
+template <typename Q>
+run_result_t run_once(std::size_t threads, const bench::options_t& opts, bench::element_pool& pool) {
+  Q queue{ threads };
+  std::atomic_bool done{ false };
+  std::size_t samples = 0, sum = 0, peak = 0;
+
+  std::thread sampler{ [&] {
+    while (!done.load(std::memory_order_relaxed)) {
+      const auto bytes = held_bytes(queue);
+      samples += 1;
+      sum += bytes;
+      peak = std::max(peak, bytes);
+      std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+    }
+  } };
+
+  const auto elapsed = bench::run_threads(threads, opts.pin, [&](std::size_t t) {
+    for (std::size_t op = 0; op < opts.ops; ++op) {
+      queue.enqueue(pool.get(op), t);
+      volatile auto res = queue.dequeue(t);
+      (void) res;
+    }
+  });
+
+  done.store(true);
+  sampler.join();
+
+  const auto mean = samples == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(samples);
+  return { elapsed, mean, peak };
+}
+
+template <typename Reclaim>
+void run_policy(std::string_view policy, const bench::options_t& opts, bench::csv_writer& csv) {
+  using queue_type = reclaim_queue<Reclaim>;
+
+  bench::element_pool pool{ 1024 };
+  for (auto threads : opts.thread_counts()) {
+    std::vector<double> ops_per_sec{};
+    std::vector<double> mean_bytes{};
+    std::size_t peak_bytes = 0;
+
+    for (std::size_t run = 0; run < opts.runs; ++run) {
+      const auto res = run_once<queue_type>(threads, opts, pool);
+      ops_per_sec.push_back(static_cast<double>(2 * threads * opts.ops) / (res.elapsed / 1e9));
+      mean_bytes.push_back(res.mean_bytes);
+      peak_bytes = std::max(peak_bytes, res.peak_bytes);
+    }
+
+    const auto ops = bench::summary_t::of(ops_per_sec);
+    const auto bytes = bench::summary_t::of(mean_bytes);
+    csv.row(policy, threads, ops.mean, ops.stddev, bytes.mean, peak_bytes);
+  }
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    "policy,threads,ops_per_sec,ops_per_sec_stddev,mean_bytes_held,peak_bytes_held"
+  };
+
+  if (!ymc::queue<int>{ 1 }.stats().enabled) {
+    std::cerr << "memory held is only reported with YMC_QUEUE_STATS=ON" << std::endl;
+  }
+
+  run_policy<ymc::hazard_reclaim>("hazard", opts, csv);
+  run_policy<ymc::eager_reclaim<2>>("eager_2", opts, csv);
+  run_policy<ymc::eager_reclaim<16>>("eager_16", opts, csv);
+  run_policy<ymc::background_hazard_reclaim<>>("background", opts, csv);
+  run_policy<ymc::epoch_reclaim>("epoch", opts, csv);
+}
@@ -0,0 +1,116 @@
+#include <memory>
+#include <string_view>
+
+#include "common.hpp"
+
+#include "ymcqueue/select.hpp"
+
+namespace {
+using queue_type = ymc::queue<int>;
+
+/** How the consumer reads from the busy and the idle queues. */
+enum class consumer_t { round_robin, select_poll, select_wait };
+
+std::string_view name_of(consumer_t consumer) {
+  switch (consumer) {
+    case consumer_t::round_robin: return "round_robin";
+    case consumer_t::select_poll: return "select_poll";
+    case consumer_t::select_wait: return "select_wait";
+  }
+
+  return "unknown";
+}
+
+/** The result of a single run. */
+struct run_result_t {
+  double elapsed;
+  /** Cells claimed by the consumer in the idle queues. */
+  std::uint64_t idle_claims;
+  /** Nodes allocated by the idle queues. */
+  std::size_t idle_nodes;
+};
+
+/**
+ * Transfers `ops` elements from a producer to a consumer through a single busy queue, which
+ * comes last among `idle + 1` queues, so the consumer passes all idle queues for every element.
+ */
+run_result_t run_once(consumer_t consumer, std::size_t idle, const bench::options_t& opts, bench::element_pool& pool) {
+  std::vector<std::unique_ptr<queue_type>> queues{};
+  std::vector<ymc::select_source<queue_type>> sources{};
+  for (std::size_t i = 0; i <= idle; ++i) {
+    queues.push_back(std::make_unique<queue_type>(2));
+    sources.push_back({ queues.back().get(), 1 });
+  }
+
+  auto& busy = *queues.back();
+  ymc::select<queue_type> select{ sources };
+
+  const auto elapsed = bench::run_threads(2, opts.pin, [&](std::size_t t) {
+    if (t == 0) {
+      for (std::size_t op = 0; op < opts.ops; ++op) {
+        busy.enqueue(pool.get(op), 0);
+      }
+
+      return;
+    }
+
+    for (std::size_t received = 0; received < opts.ops;) {
+      if (consumer == consumer_t::round_robin) {
+        for (auto& queue : queues) {
+          if (queue->dequeue(1) != nullptr) {
+            received += 1;
+          }
+        }
+      } else {
+        const auto res = consumer == consumer_t::select_poll
+            ? select.try_dequeue()
+            : select.dequeue_wait();
+        received += res ? 1 : 0;
+      }
+    }
+  });
+
+  run_result_t res{ elapsed, 0, 0 };
+  for (std::size_t i = 0; i < idle; ++i) {
+    const auto stats = queues[i]->stats();
+    res.idle_claims += stats.fast_dequeues + stats.slow_dequeues;
+    res.idle_nodes += queues[i]->pool_stats().misses;
+  }
+
+  return res;
+}
+}
+
+int main(int argc, char** argv) {
+  const auto opts = bench::options_t::parse(argc, argv);
+  bench::csv_writer csv{
+    opts.csv,
+    "consumer,idle_queues,elements_per_sec,elements_per_sec_stddev,idle_claims_per_element,idle_nodes"
+  };
+  bench::element_pool pool{ 1024 };
+
+  for (const auto consumer : { consumer_t::round_robin, consumer_t::select_poll, consumer_t::select_wait }) {
+    for (const std::size_t idle : { 1, 4, 16 }) {
+      std::vector<double> per_sec{};
+      std::vector<double> claims{};
+      std::vector<double> nodes{};
+
+      for (std::size_t run = 0; run < opts.runs; ++run) {
+        const auto res = run_once(consumer, idle, opts, pool);
+        per_sec.push_back(static_cast<double>(opts.ops) / (res.elapsed / 1e9));
+        claims.push_back(static_cast<double>(res.idle_claims) / static_cast<double>(opts.ops));
+        nodes.push_back(static_cast<double>(res.idle_nodes));
+      }
+
+      const auto throughput = bench::summary_t::of(per_sec);
+      csv.row(
+          name_of(consumer),
+          idle,
+          throughput.mean,
+          throughput.stddev,
+          bench::summary_t::of(claims).mean,
+          bench::summary_t::of(nodes).mean
+      );
+    }
+  }
+}
@@ -0,0 +1,400 @@
+#ifndef YMC_BENCH_COMMON_HPP
+#define YMC_BENCH_COMMON_HPP
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace bench {
+/** Command line options shared by all benchmark executables. */
+struct options_t {
+  /** Number of repeated runs per configuration. */
+  std::size_t runs{ 5 };
+  /** Number of operations performed by each thread per run. */
+  std::size_t ops{ 1000 * 1000 };
+  /** Maximum thread count, defaults to all available cores. */
+  std::size_t max_threads{ std::thread::hardware_concurrency() };
+  /** Whether to pin threads to cores. */
+  bool pin{ true };
+  /** Output path for the CSV results, empty for stdout. */
+  std::string csv{};
+  /** Whether to count hardware events per thread around the measured loop. */
+  bool perf{ false };
+  /**
+   * The raw (model-specific) perf event config counting RFOs, e.g. the offcore demand RFO
+   * requests, 0 for the generic L1D write misses instead.
+   */
+  std::uint64_t rfo_event{ 0 };
+
+  /** Parses `--runs N --ops N --threads N --no-pin --csv PATH --perf --rfo-event CONFIG`. */
+  static options_t parse(int argc, char** argv) {
+    options_t opts{};
+    for (auto i = 1; i < argc; ++i) {
+      const std::string_view arg{ argv[i] };
+      const auto next = [&]() -> const char* {
+        if (i + 1 >= argc) {
+          std::cerr << "missing value for " << arg << std::endl;
+          std::exit(1);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--runs") {
+        opts.runs = std::strtoull(next(), nullptr, 10);
+      } else if (arg == "--ops") {
+        opts.ops = std::strtoull(next(), nullptr, 10);
+      } else if (arg == "--threads") {
+        opts.max_threads = std::strtoull(next(), nullptr, 10);
+      } else if (arg == "--no-pin") {
+        opts.pin = false;
+      } else if (arg == "--csv") {
+        opts.csv = next();
+      } else if (arg == "--perf") {
+        opts.perf = true;
+      } else if (arg == "--rfo-event") {
+        opts.rfo_event = std::strtoull(next(), nullptr, 0);
+      } else {
+        std::cerr << "unknown argument: " << arg << std::endl;
+        std::exit(1);
+      }
+    }
+
+    if (opts.max_threads == 0) {
+      opts.max_threads = 1;
+    }
+
+    if (opts.runs == 0) {
+      opts.runs = 1;
+    }
+
+    return opts;
+  }
+
+  /** Returns the thread counts to benchmark: 1, 2, 4, ... and `max_threads`. */
+  std::vector<std::size_t> thread_counts() const {
+    std::vector<std::size_t> counts{};
+    for (std::size_t t = 1; t < this->max_threads; t *= 2) {
+      counts.push_back(t);
+    }
+    counts.push_back(this->max_threads);
+    return counts;
+  }
+};
+
+/** Pins the calling thread to the given core (modulo the available cores). */
+inline void pin_thread(std::size_t core) {
+  const auto cores = std::max(1u, std::thread::hardware_concurrency());
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % cores, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/** Mean and standard deviation of a series of samples. */
+struct summary_t {
+  double mean{ 0.0 };
+  double stddev{ 0.0 };
+
+  static summary_t of(const std::vector<double>& samples) {
+    summary_t res{};
+    if (samples.empty()) {
+      return res;
+    }
+
+    for (auto s : samples) {
+      res.mean += s;
+    }
+    res.mean /= static_cast<double>(samples.size());
+
+    for (auto s : samples) {
+      res.stddev += (s - res.mean) * (s - res.mean);
+    }
+    res.stddev = std::sqrt(res.stddev / static_cast<double>(samples.size()));
+
+    return res;
+  }
+};
+
+/** The hardware events counted per thread with `--perf`. */
+enum class perf_event_t : std::size_t {
+  cycles,
+  instructions,
+  l1d_misses,
+  llc_misses,
+  /** Requests for ownership, see `options_t::rfo_event`. */
+  rfos,
+  COUNT,
+};
+
+constexpr std::size_t PERF_EVENTS = static_cast<std::size_t>(perf_event_t::COUNT);
+
+/** The CSV columns of the per-operation event counts, in the order of `perf_event_t`. */
+constexpr std::string_view PERF_COLUMNS =
+    "cycles_per_op,instructions_per_op,l1d_misses_per_op,llc_misses_per_op,rfos_per_op";
+
+/**
+ * Hardware event counts summed over all threads of a run, events which could not be counted on
+ * any thread (unsupported by the CPU or not permitted by the kernel) are marked missing.
+ */
+struct perf_totals_t {
+  std::uint64_t rfo_event{ 0 };
+  std::array<std::atomic_uint64_t, PERF_EVENTS> counts{};
+  std::array<std::atomic_bool, PERF_EVENTS> missing{};
+
+  explicit perf_totals_t(std::uint64_t rfo_event) : rfo_event{ rfo_event } {}
+
+  /** Returns the counts divided by `ops`, NaN for missing events. */
+  std::array<double, PERF_EVENTS> per_op(double ops) const {
+    std::array<double, PERF_EVENTS> res{};
+    for (std::size_t i = 0; i < PERF_EVENTS; ++i) {
+      res[i] = this->missing[i].load()
+          ? std::nan("")
+          : static_cast<double>(this->counts[i].load()) / ops;
+    }
+
+    return res;
+  }
+};
+
+/** Per-operation event counts, averaged over several runs, which print as CSV columns. */
+struct perf_columns_t {
+  std::array<double, PERF_EVENTS> values{};
+
+  static perf_columns_t of(const std::vector<std::array<double, PERF_EVENTS>>& runs) {
+    perf_columns_t res{};
+    for (const auto& run : runs) {
+      for (std::size_t i = 0; i < PERF_EVENTS; ++i) {
+        res.values[i] += run[i] / static_cast<double>(runs.size());
+      }
+    }
+
+    return res;
+  }
+
+  friend std::ostream& operator<<(std::ostream& out, const perf_columns_t& columns) {
+    for (std::size_t i = 0; i < PERF_EVENTS; ++i) {
+      out << (i == 0 ? "" : ",") << columns.values[i];
+    }
+
+    return out;
+  }
+};
+
+/** Returns the CSV header, extended by the event columns if hardware events are counted. */
+inline std::string csv_header(std::string_view header, const options_t& opts) {
+  std::string res{ header };
+  if (opts.perf) {
+    res.append(",").append(PERF_COLUMNS);
+  }
+
+  return res;
+}
+
+/**
+ * The hardware event counters of the calling thread (user space only), which are opened on
+ * construction and must be started and stopped by the same thread.
+ */
+class perf_counters_t {
+  std::array<int, PERF_EVENTS> m_fds{};
+
+  static int open(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  static constexpr std::uint64_t cache_event(std::uint64_t cache, std::uint64_t op) {
+    return cache | (op << 8) | (std::uint64_t{ PERF_COUNT_HW_CACHE_RESULT_MISS } << 16);
+  }
+
+public:
+  explicit perf_counters_t(std::uint64_t rfo_event) {
+    using enum perf_event_t;
+    const auto idx = [](perf_event_t event) { return static_cast<std::size_t>(event); };
+    this->m_fds[idx(cycles)] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    this->m_fds[idx(instructions)] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    this->m_fds[idx(l1d_misses)] = open(
+        PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ));
+    this->m_fds[idx(llc_misses)] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    this->m_fds[idx(rfos)] = rfo_event != 0
+        ? open(PERF_TYPE_RAW, rfo_event)
+        : open(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_WRITE));
+  }
+
+  ~perf_counters_t() noexcept {
+    for (auto fd : this->m_fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  void start() noexcept {
+    for (auto fd : this->m_fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+
+  /** Stops counting and adds the counts, scaled up if events were multiplexed, to `totals`. */
+  void stop(perf_totals_t& totals) noexcept {
+    for (std::size_t i = 0; i < PERF_EVENTS; ++i) {
+      const auto fd = this->m_fds[i];
+      std::uint64_t values[3]{};
+      if (
+          fd < 0
+          || ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) != 0
+          || read(fd, values, sizeof(values)) != sizeof(values)
+          || values[2] == 0
+      ) {
+        totals.missing[i].store(true);
+        continue;
+      }
+
+      const auto scaled = static_cast<double>(values[0]) * values[1] / values[2];
+      totals.counts[i].fetch_add(static_cast<std::uint64_t>(scaled));
+    }
+  }
+
+  perf_counters_t(const perf_counters_t&)            = delete;
+  perf_counters_t& operator=(const perf_counters_t&) = delete;
+};
+
+/**
+ * Runs `f(thread_id)` on `threads` threads, which are released simultaneously, and returns the
+ * elapsed wall-clock time in nanoseconds.
+ *
+ * If `perf` is given, each thread counts hardware events around its call of `f` and adds them to
+ * `perf`.
+ */
+template <typename F>
+double run_threads(std::size_t threads, bool pin, F&& f, perf_totals_t* perf = nullptr) {
+  std::vector<std::thread> workers{};
+  workers.reserve(threads);
+
+  std::atomic_size_t ready{ 0 };
+  std::atomic_bool start{ false };
+
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      if (pin) {
+        pin_thread(t);
+      }
+
+      std::optional<perf_counters_t> counters{};
+      if (perf != nullptr) {
+        counters.emplace(perf->rfo_event);
+      }
+
+      ready.fetch_add(1);
+      while (!start.load()) {}
+
+      if (counters) {
+        counters->start();
+        f(t);
+        counters->stop(*perf);
+      } else {
+        f(t);
+      }
+    });
+  }
+
+  while (ready.load() < threads) {}
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+/** Writes benchmark results as CSV, either to a file or to stdout. */
+class csv_writer {
+  std::ofstream m_file{};
+  std::ostream* m_out{ &std::cout };
+
+public:
+  csv_writer(const std::string& path, std::string_view header) {
+    if (!path.empty()) {
+      this->m_file.open(path);
+      if (!this->m_file) {
+        std::cerr << "failed to open " << path << std::endl;
+        std::exit(1);
+      }
+      this->m_out = &this->m_file;
+    }
+
+    *this->m_out << header << '\n';
+  }
+
+  template <typename... Args>
+  void row(const Args&... args) {
+    auto first = true;
+    ((*this->m_out << (first ? "" : ",") << args, first = false), ...);
+    *this->m_out << std::endl;
+  }
+};
+
+/**
+ * A pool of distinct element addresses to transport through the queues, since both queue engines
+ * only transport pointers.
+ */
+class element_pool {
+  std::vector<int> m_storage;
+public:
+  explicit element_pool(std::size_t count) : m_storage(count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      this->m_storage[i] = static_cast<int>(i);
+    }
+  }
+
+  int* get(std::size_t idx) { return &this->m_storage[idx % this->m_storage.size()]; }
+};
+
+/** A small xorshift PRNG, cheap enough for use inside measured loops. */
+class xorshift {
+  std::uint64_t m_state;
+public:
+  explicit xorshift(std::uint64_t seed) : m_state{ seed * 0x9E3779B97F4A7C15ull + 1 } {}
+
+  std::uint64_t next() {
+    auto x = this->m_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return this->m_state = x;
+  }
+};
+}
+
+#endif /* YMC_BENCH_COMMON_HPP */
@@ -0,0 +1,266 @@
+#ifndef YMC_ASYNC_QUEUE_HPP
+#define YMC_ASYNC_QUEUE_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+
+#include "ymcqueue/queue.hpp"
+#include "private/value_encoding.hpp"
+
+namespace ymc {
+/**
+ * A wait-free MPMC queue of `T*` elements, whose consumers can `co_await` elements from C++20
+ * coroutines instead of polling.
+ *
+ * `co_await queue.async_dequeue(thread_id, executor)` completes immediately if an element can be
+ * dequeued. Otherwise, the coroutine registers its thread id in a waiter list, which is itself a
+ * wait-free queue, and suspends. An enqueue finding registered waiters claims one, dequeues the
+ * element at the queue's front on its behalf and resumes it through its executor, which can be
+ * any type with a thread-safe `post(std::coroutine_handle<>)` method.
+ *
+ * Each thread id must have at most one pending `async_dequeue` at any time.
+ */
+template <
+    typename T,
+    std::size_t NodeSize = detail::NODE_SIZE,
+    std::size_t Patience = detail::PATIENCE,
+    std::size_t MaxThreads = detail::MAX_THREADS,
+    typename Layout = padded_cells,
+    typename Reclaim = hazard_reclaim
+>
+class basic_async_queue {
+  using config_type = detail::queue_config_t<
+      NodeSize, Patience, MaxThreads, Layout, Reclaim
+  >;
+  using engine_type = detail::erased_queue_t<config_type>;
+
+  /**
+   * The states of a thread id's waiter slot, stored in the low bits of the slot's state word. The
+   * upper bits hold a generation incremented by every registration, so a coroutine resumed (and
+   * awaiting again) before its previous registration is cancelled can not be mistaken for it.
+   */
+  static constexpr std::uint64_t IDLE = 0;
+  static constexpr std::uint64_t WAITING = 1;
+  static constexpr std::uint64_t CLAIMED = 2;
+  static constexpr std::uint64_t STATE_MASK = 3;
+  static constexpr std::uint64_t GENERATION = 4;
+
+  /** The suspended coroutine of a thread id and where to resume it. */
+  struct alignas(64) waiter_t {
+    std::atomic_uint64_t state{ IDLE };
+    std::coroutine_handle<> coro{};
+    void* executor{ nullptr };
+    void (*post)(void* executor, std::coroutine_handle<> coro){ nullptr };
+    /** The element dequeued on the waiter's behalf by the enqueuer resuming it. */
+    void* elem{ nullptr };
+  };
+
+  /** the queue of elements */
+  engine_type m_queue;
+  /** The thread ids of (possibly) waiting consumers, entries of cancelled waits are skipped. */
+  engine_type m_waiters;
+  /** The number of entries in the waiter list. */
+  alignas(64) std::atomic_size_t m_waiting{ 0 };
+  std::unique_ptr<waiter_t[]> m_slots;
+
+  /** Registers the given thread id in the waiter list, returns the registration's state word. */
+  std::uint64_t register_waiter(std::size_t thread_id) {
+    auto& state = this->m_slots[thread_id].state;
+    // the slot is idle, so only its owner writes the state until it is registered
+    const auto waiting =
+        ((state.load(std::memory_order_relaxed) & ~STATE_MASK) + GENERATION) | WAITING;
+    state.store(waiting, std::memory_order_seq_cst);
+    this->m_waiting.fetch_add(1, std::memory_order_seq_cst);
+    this->m_waiters.enqueue(
+        detail::encode_value(static_cast<std::uint32_t>(thread_id)), thread_id);
+    return waiting;
+  }
+
+  /**
+   * Suspends the given coroutine until an element is dequeued on its behalf, returns false with
+   * `elem` set, if an element could be dequeued right away instead.
+   *
+   * Once registered, the coroutine may be resumed concurrently, so the awaiter (and `elem`) must
+   * only be accessed again if the registration is cancelled.
+   */
+  bool suspend(
+      std::size_t thread_id,
+      std::coroutine_handle<> coro,
+      void* executor,
+      void (*post)(void*, std::coroutine_handle<>),
+      void*& elem
+  ) {
+    auto& slot = this->m_slots[thread_id];
+    slot.coro = coro;
+    slot.executor = executor;
+    slot.post = post;
+    slot.elem = nullptr;
+
+    while (true) {
+      auto expected = this->register_waiter(thread_id);
+
+      // an enqueue either observes the registration or its element is observed here
+      if (this->m_queue.empty()) {
+        return true;
+      }
+
+      // an enqueuer has already claimed the registration and will resume the coroutine, which
+      // may even have registered again, so only this registration's generation is cancelled
+      if (!slot.state.compare_exchange_strong(
+              expected, expected & ~STATE_MASK, std::memory_order_seq_cst)) {
+        return true;
+      }
+
+      if ((elem = this->m_queue.try_dequeue(thread_id)) != nullptr) {
+        return false;
+      }
+    }
+  }
+
+  /** Resumes a registered waiter with the element at the queue's front, if there are any. */
+  void wake(std::size_t thread_id) {
+    while (this->m_waiting.load(std::memory_order_seq_cst) != 0) {
+      const auto entry = this->m_waiters.try_dequeue(thread_id);
+      if (entry == nullptr) {
+        // the registration is still in progress and will observe the enqueued element
+        return;
+      }
+
+      this->m_waiting.fetch_sub(1, std::memory_order_relaxed);
+      const auto waiter_id = *detail::decode_value<std::uint32_t>(entry);
+      auto& slot = this->m_slots[waiter_id];
+
+      // entries of cancelled registrations may claim a later registration of the same thread id
+      auto expected = slot.state.load(std::memory_order_seq_cst);
+      if ((expected & STATE_MASK) != WAITING || !slot.state.compare_exchange_strong(
+              expected, (expected & ~STATE_MASK) | CLAIMED, std::memory_order_seq_cst)) {
+        continue;
+      }
+
+      const auto generation = expected & ~STATE_MASK;
+      if (auto elem = this->m_queue.try_dequeue(thread_id); elem != nullptr) {
+        slot.elem = elem;
+        slot.state.store(generation | IDLE, std::memory_order_relaxed);
+        slot.post(slot.executor, slot.coro);
+        return;
+      }
+
+      // the element was taken by another consumer, so the claimed waiter keeps waiting
+      slot.state.store(generation | WAITING, std::memory_order_seq_cst);
+      this->m_waiting.fetch_add(1, std::memory_order_seq_cst);
+      this->m_waiters.enqueue(entry, thread_id);
+      if (this->m_queue.empty()) {
+        return;
+      }
+    }
+  }
+
+public:
+  using pointer = T*;
+
+  /** The awaitable returned by `async_dequeue`, which resumes with the dequeued element. */
+  class dequeue_awaiter {
+    basic_async_queue* m_queue;
+    std::size_t m_thread_id;
+    void* m_executor;
+    void (*m_post)(void*, std::coroutine_handle<>);
+    void* m_elem{ nullptr };
+
+  public:
+    dequeue_awaiter(
+        basic_async_queue& queue,
+        std::size_t thread_id,
+        void* executor,
+        void (*post)(void*, std::coroutine_handle<>)
+    ) : m_queue{ &queue }, m_thread_id{ thread_id }, m_executor{ executor }, m_post{ post } {}
+
+    bool await_ready() {
+      this->m_elem = this->m_queue->m_queue.try_dequeue(this->m_thread_id);
+      return this->m_elem != nullptr;
+    }
+
+    bool await_suspend(std::coroutine_handle<> coro) {
+      return this->m_queue->suspend(
+          this->m_thread_id, coro, this->m_executor, this->m_post, this->m_elem);
+    }
+
+    pointer await_resume() noexcept {
+      if (this->m_elem == nullptr) {
+        this->m_elem = this->m_queue->m_slots[this->m_thread_id].elem;
+      }
+
+      return reinterpret_cast<pointer>(this->m_elem);
+    }
+  };
+
+  /** constructor & destructor */
+  explicit basic_async_queue(std::size_t max_threads = MaxThreads) :
+    m_queue{ max_threads },
+    m_waiters{ max_threads },
+    m_slots{ std::make_unique<waiter_t[]>(max_threads) }
+  {}
+
+  ~basic_async_queue() noexcept = default;
+
+  /** Enqueues the given `elem` at the queue's back and resumes a waiting consumer, if any. */
+  void enqueue(pointer elem, std::size_t thread_id) {
+    this->m_queue.enqueue(reinterpret_cast<void*>(elem), thread_id);
+    if (this->m_waiting.load(std::memory_order_seq_cst) != 0) {
+      this->wake(thread_id);
+    }
+  }
+
+  /**
+   * Enqueues the given `elem` like `enqueue`, the returned awaitable never suspends, since the
+   * queue is unbounded and enqueue is wait-free.
+   */
+  std::suspend_never async_enqueue(pointer elem, std::size_t thread_id) {
+    this->enqueue(elem, thread_id);
+    return {};
+  }
+
+  /** Dequeues an element from the queue's front, returns nullptr if the queue is empty. */
+  pointer dequeue(std::size_t thread_id) {
+    return reinterpret_cast<pointer>(this->m_queue.dequeue(thread_id));
+  }
+
+  /**
+   * Returns an awaitable dequeueing an element from the queue's front, which suspends the awaiting
+   * coroutine while the queue is empty and resumes it through `executor` once an element has been
+   * dequeued on its behalf.
+   */
+  template <typename Executor>
+  [[nodiscard]] dequeue_awaiter async_dequeue(std::size_t thread_id, Executor& executor) {
+    return dequeue_awaiter{
+      *this,
+      thread_id,
+      &executor,
+      [](void* ex, std::coroutine_handle<> coro) { static_cast<Executor*>(ex)->post(coro); }
+    };
+  }
+
+  /** Returns the approximate number of elements in the queue. */
+  std::size_t size_approx() const noexcept {
+    return this->m_queue.size_approx();
+  }
+
+  /** Returns true if the queue appears empty. */
+  bool empty() const noexcept {
+    return this->m_queue.empty();
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  basic_async_queue(const basic_async_queue&)                  = delete;
+  basic_async_queue(basic_async_queue&&)                       = delete;
+  const basic_async_queue& operator=(const basic_async_queue&) = delete;
+  const basic_async_queue& operator=(basic_async_queue&&)      = delete;
+};
+
+/** An async queue with the default node size, patience and maximum number of thread handles. */
+template <typename T>
+using async_queue = basic_async_queue<T>;
+}
+
+#endif /* YMC_ASYNC_QUEUE_HPP */
@@ -0,0 +1,89 @@
+#ifndef YMC_EXECUTOR_HPP
+#define YMC_EXECUTOR_HPP
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+
+namespace ymc {
+/**
+ * A minimal executor resuming posted coroutines on the single thread calling `run`.
+ *
+ * Any type with a thread-safe `post(std::coroutine_handle<>)` method can be used as the executor
+ * of an async queue instead.
+ */
+class single_thread_executor {
+  std::mutex m_mutex{};
+  std::condition_variable m_cv{};
+  std::deque<std::coroutine_handle<>> m_ready{};
+  bool m_stopped{ false };
+
+public:
+  /** constructor & destructor */
+  single_thread_executor() = default;
+  ~single_thread_executor() noexcept = default;
+
+  /** Schedules the given coroutine for resumption, may be called from any thread. */
+  void post(std::coroutine_handle<> coro) {
+    {
+      std::lock_guard lock{ this->m_mutex };
+      this->m_ready.push_back(coro);
+    }
+
+    this->m_cv.notify_one();
+  }
+
+  /** Resumes posted coroutines until `stop` has been called and no coroutine is ready. */
+  void run() {
+    while (true) {
+      std::coroutine_handle<> coro{};
+      {
+        std::unique_lock lock{ this->m_mutex };
+        this->m_cv.wait(lock, [this] { return this->m_stopped || !this->m_ready.empty(); });
+        if (this->m_ready.empty()) {
+          return;
+        }
+
+        coro = this->m_ready.front();
+        this->m_ready.pop_front();
+      }
+
+      coro.resume();
+    }
+  }
+
+  /** Resumes all coroutines posted so far without waiting, returns their number. */
+  std::size_t poll() {
+    std::deque<std::coroutine_handle<>> ready{};
+    {
+      std::lock_guard lock{ this->m_mutex };
+      ready.swap(this->m_ready);
+    }
+
+    for (auto coro : ready) {
+      coro.resume();
+    }
+
+    return ready.size();
+  }
+
+  /** Makes `run` return once all posted coroutines have been resumed. */
+  void stop() {
+    {
+      std::lock_guard lock{ this->m_mutex };
+      this->m_stopped = true;
+    }
+
+    this->m_cv.notify_all();
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  single_thread_executor(const single_thread_executor&)                  = delete;
+  single_thread_executor(single_thread_executor&&)                       = delete;
+  const single_thread_executor& operator=(const single_thread_executor&) = delete;
+  const single_thread_executor& operator=(single_thread_executor&&)      = delete;
+};
+}
+
+#endif /* YMC_EXECUTOR_HPP */
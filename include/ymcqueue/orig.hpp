@@ -1,6 +1,7 @@
 #ifndef YMC_QUEUE_ORIG_HPP
 #define YMC_QUEUE_ORIG_HPP
 
+#include <cstdlib>
 #include <vector>
 
 #include "wfqueue.h"
@@ -45,8 +46,8 @@ public:
     for (auto i = 0; auto& handle : this->m_handles) {
       auto next = i == max_threads - 1 ? &this->m_handles[0] : &this->m_handles[i + 1];
       handle.next = next;
-      handle.enq_help_handle = next;
-      handle.deq_help_handle = next;
+      handle.Eh = next;
+      handle.Dh = next;
 
       i += 1;
     }
@@ -58,12 +59,12 @@ public:
     while (curr != nullptr) {
       auto tmp = curr;
       curr = curr->next;
-      delete tmp;
+      std::free(tmp);
     }
 
     // delete any remaining thread-local spare nodes
     for (auto& handle : this->m_handles) {
-      delete handle.spare;
+      std::free(handle.spare);
     }
   }
 
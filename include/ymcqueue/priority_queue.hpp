@@ -0,0 +1,163 @@
+#ifndef YMC_PRIORITY_QUEUE_HPP
+#define YMC_PRIORITY_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "ymcqueue/queue.hpp"
+
+namespace ymc {
+/**
+ * A wait-free MPMC queue of `T*` elements with `Levels` strict priority classes (lanes), where
+ * level 0 has the highest priority.
+ *
+ * Each lane is an independent wait-free FIFO queue and all lanes are addressed with the same
+ * thread ids. A summary word holds one bit per lane, which is set by enqueuers and cleared by
+ * dequeuers finding the lane empty, so a dequeue goes straight to the highest lane that may be
+ * non-empty and never claims a cell in an empty lane. A dequeue visits every lane at most twice.
+ */
+template <
+    typename T,
+    std::size_t Levels,
+    std::size_t NodeSize = detail::NODE_SIZE,
+    std::size_t Patience = detail::PATIENCE,
+    std::size_t MaxThreads = detail::MAX_THREADS,
+    typename Layout = padded_cells,
+    typename Reclaim = hazard_reclaim
+>
+class basic_priority_queue {
+  static_assert(Levels > 0 && Levels <= 64, "priority queues support between 1 and 64 levels");
+
+  using config_type = detail::queue_config_t<
+      NodeSize, Patience, MaxThreads, Layout, Reclaim
+  >;
+  using lane_type = detail::erased_queue_t<config_type>;
+
+  /** One bit per lane, set if the lane may be non-empty. */
+  alignas(64) std::atomic_uint64_t m_summary{ 0 };
+  /** The lanes, ordered by decreasing priority. */
+  std::array<std::unique_ptr<lane_type>, Levels> m_lanes;
+
+  /**
+   * Clears the summary bit of the given lane, which appeared empty, and sets it again if an
+   * element was enqueued concurrently, returns true in that case.
+   *
+   * Enqueuers increment the lane's enqueue index before they set the bit and both accesses are
+   * sequentially consistent, so either the enqueuer sets the bit after it has been cleared or the
+   * lane is seen as non-empty here.
+   */
+  bool clear_summary(std::size_t level) noexcept {
+    const auto bit = std::uint64_t{ 1 } << level;
+    this->m_summary.fetch_and(~bit, std::memory_order_seq_cst);
+    if (this->m_lanes[level]->empty()) {
+      return false;
+    }
+
+    this->m_summary.fetch_or(bit, std::memory_order_seq_cst);
+    return true;
+  }
+
+public:
+  using pointer = T*;
+  /** The number of priority levels. */
+  static constexpr std::size_t LEVELS = Levels;
+
+  /** constructor & destructor */
+  explicit basic_priority_queue(std::size_t max_threads = MaxThreads) {
+    for (auto& lane : this->m_lanes) {
+      lane = std::make_unique<lane_type>(max_threads);
+    }
+  }
+
+  ~basic_priority_queue() noexcept = default;
+
+  /** Enqueues the given `elem` at the back of the lane with the given priority `level`. */
+  void enqueue(pointer elem, std::size_t level, std::size_t thread_id) {
+    if (level >= Levels) {
+      throw std::invalid_argument("priority level out of range");
+    }
+
+    this->m_lanes[level]->enqueue(reinterpret_cast<void*>(elem), thread_id);
+
+    // avoid the read-modify-write if the bit is already set, see `clear_summary`
+    const auto bit = std::uint64_t{ 1 } << level;
+    if ((this->m_summary.load(std::memory_order_seq_cst) & bit) == 0) {
+      this->m_summary.fetch_or(bit, std::memory_order_seq_cst);
+    }
+  }
+
+  /**
+   * Dequeues an element from the front of the highest-priority non-empty lane, returns nullptr if
+   * all lanes appear empty.
+   */
+  pointer dequeue(std::size_t thread_id) {
+    std::size_t level = 0;
+    return this->dequeue(thread_id, level);
+  }
+
+  /**
+   * Dequeues an element from the front of the highest-priority non-empty lane and stores its
+   * priority in `level`, returns nullptr if all lanes appear empty.
+   */
+  pointer dequeue(std::size_t thread_id, std::size_t& level) {
+    auto summary = this->m_summary.load(std::memory_order_seq_cst);
+    while (summary != 0) {
+      const auto lane = static_cast<std::size_t>(std::countr_zero(summary));
+      summary &= summary - 1;
+
+      // a lane which is refilled while it is being cleared is tried once more
+      for (auto attempt = 0; attempt < 2; ++attempt) {
+        if (auto elem = this->m_lanes[lane]->try_dequeue(thread_id); elem != nullptr) {
+          level = lane;
+          return reinterpret_cast<pointer>(elem);
+        }
+
+        if (!this->clear_summary(lane)) {
+          break;
+        }
+      }
+    }
+
+    return nullptr;
+  }
+
+  /** Returns the approximate number of elements in the lane with the given priority `level`. */
+  std::size_t size_approx(std::size_t level) const noexcept {
+    return this->m_lanes[level]->size_approx();
+  }
+
+  /** Returns the approximate number of elements in all lanes. */
+  std::size_t size_approx() const noexcept {
+    std::size_t res = 0;
+    for (const auto& lane : this->m_lanes) {
+      res += lane->size_approx();
+    }
+
+    return res;
+  }
+
+  /** Returns true if all lanes appear empty, without touching any lane. */
+  bool empty() const noexcept {
+    return this->m_summary.load(std::memory_order_seq_cst) == 0;
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  basic_priority_queue(const basic_priority_queue&)                  = delete;
+  basic_priority_queue(basic_priority_queue&&)                       = delete;
+  const basic_priority_queue& operator=(const basic_priority_queue&) = delete;
+  const basic_priority_queue& operator=(basic_priority_queue&&)      = delete;
+};
+
+/**
+ * A priority queue with `Levels` lanes and the default node size, patience and maximum number of
+ * thread handles.
+ */
+template <typename T, std::size_t Levels>
+using priority_queue = basic_priority_queue<T, Levels>;
+}
+
+#endif /* YMC_PRIORITY_QUEUE_HPP */
@@ -1,35 +1,298 @@
 #ifndef YMC_QUEUE_HPP
 #define YMC_QUEUE_HPP
 
+#include <chrono>
+#include <span>
+
 #include "private/erased_queue.hpp"
 
 namespace ymc {
-template <typename T>
-class queue {
+/** Statistics of a queue's node pool. */
+using node_pool_stats = detail::node_pool_stats_t;
+/** The maximum number of elements a bounded queue accepts through `try_enqueue`. */
+using capacity = detail::capacity_t;
+/** A snapshot of a queue's operation counters, see `detail::queue_stats_t`. */
+using queue_stats = detail::queue_stats_t;
+/** A mergeable log-linear latency histogram, see `detail::latency_histogram_t`. */
+using latency_histogram = detail::latency_histogram_t;
+/** The p50/p99/p99.9/max summary of a latency histogram. */
+using latency_summary = detail::latency_summary_t;
+/** Latency histograms of a queue's operations, see `detail::queue_latencies_t`. */
+using queue_latencies = detail::queue_latencies_t;
+/** A move-only claim of one of a queue's thread handles, released on destruction. */
+using thread_handle = detail::handle_token_t;
+/** The source of a queue's node memory, see `detail::node_memory_t`. */
+using node_memory = detail::node_memory_t;
+/** Cell layout policy padding each cell to its own cache line (the default). */
+using padded_cells = detail::padded_layout_t;
+/** Cell layout policy storing cell values densely apart from the request pointers. */
+using split_cells = detail::split_layout_t;
+/** Cell layout policy storing unpadded cells with swizzled positions. */
+using dense_cells = detail::dense_layout_t;
+/** Reclamation policy running cleanup in dequeuers every `2 * max_threads` nodes (the default). */
+using hazard_reclaim = detail::hazard_reclaim_t;
+/** Reclamation policy running cleanup in dequeuers every `Nodes` nodes. */
+template <std::size_t Nodes>
+using eager_reclaim = detail::eager_reclaim_t<Nodes>;
+/**
+ * Reclamation policy running the hazard cleanup every `IntervalMicros` in a background thread
+ * owned by the queue, backing off while the queue is idle.
+ */
+template <std::size_t IntervalMicros = 100>
+using background_hazard_reclaim = detail::background_hazard_reclaim_t<IntervalMicros>;
+/**
+ * Reclamation policy protecting the nodes of each operation by announcing the global epoch and
+ * returning nodes unlinked by cleanup to the pool once the epoch has advanced twice.
+ */
+using epoch_reclaim = detail::epoch_reclaim_t;
+/** Concurrency mode with any number of concurrent producers and consumers (the default). */
+using mpmc = detail::concurrency_mode_t<false, false>;
+/** Concurrency mode with any number of producers and at most one consumer at any time. */
+using mpsc = detail::concurrency_mode_t<false, true>;
+/** Concurrency mode with at most one producer at any time and any number of consumers. */
+using spmc = detail::concurrency_mode_t<true, false>;
+/** Concurrency mode with at most one producer and at most one consumer at any time. */
+using spsc = detail::concurrency_mode_t<true, true>;
+/** Backoff policy poisoning empty cells and retrying fast paths without waiting (the default). */
+using no_backoff = detail::no_backoff_t;
+/** Backoff policy waiting `Spins` `pause` iterations before poisoning cells and between retries. */
+template <std::uint32_t Spins>
+using fixed_backoff = detail::fixed_backoff_t<Spins>;
+/** Backoff policy waiting up to `MaxSpins` iterations in proportion to recent fast-path failures. */
+template <std::uint32_t MaxSpins>
+using adaptive_backoff = detail::adaptive_backoff_t<MaxSpins>;
+
+template <typename Q>
+class select;
+
+/**
+ * A wait-free MPMC queue of `T*` elements, specialized at compile time for the number of cells
+ * per node (`NodeSize`), the number of fast-path attempts (`Patience`), the maximum number of
+ * thread handles (`MaxThreads`), the layout of each node's cells (`Layout`), the policy
+ * deciding when and by whom retired nodes are reclaimed (`Reclaim`), the concurrency mode
+ * (`Mode`) and the policy for waiting on contended cells (`Backoff`).
+ *
+ * With a single consumer (`mpsc`, `spsc`), the dequeue index is advanced with plain stores and
+ * dequeue requests and helping are skipped entirely, a dequeue which exhausts its patience walks
+ * the following cells itself, helping pending enqueue requests on the way. With a single producer (`spmc`, `spsc`),
+ * dequeuers only check the producer's enqueue request instead of rotating through all handles.
+ */
+template <
+    typename T,
+    std::size_t NodeSize = detail::NODE_SIZE,
+    std::size_t Patience = detail::PATIENCE,
+    std::size_t MaxThreads = detail::MAX_THREADS,
+    typename Layout = padded_cells,
+    typename Reclaim = hazard_reclaim,
+    typename Mode = mpmc,
+    typename Backoff = no_backoff
+>
+class basic_queue {
+  using config_type = detail::queue_config_t<
+      NodeSize, Patience, MaxThreads, Layout, Reclaim, Mode, Backoff
+  >;
   /** the internal queue representation */
-  detail::erased_queue_t m_queue;
+  detail::erased_queue_t<config_type> m_queue;
+  /** selects check and park on the internal queue directly */
+  template <typename Q>
+  friend class select;
 public:
   using pointer = T*;
+  /** The size of each node in bytes. */
+  static constexpr std::size_t NODE_BYTES = sizeof(detail::node_t<NodeSize, Layout>);
   /** constructor & destructor */
-  explicit queue(std::size_t max_threads = 128) : m_queue{ max_threads } {}
-  ~queue() noexcept = default;
+  explicit basic_queue(std::size_t max_threads = MaxThreads) : m_queue{ max_threads } {}
+  /** Constructs a queue whose node pool retains at most `pool_high_watermark` reclaimed nodes. */
+  basic_queue(
+      std::size_t max_threads,
+      std::size_t pool_high_watermark,
+      node_memory memory = node_memory::heap
+  ) : m_queue{ max_threads, pool_high_watermark, memory } {}
+  /**
+   * Constructs a bounded queue, which accepts at most `bound` elements through `try_enqueue`
+   * and preallocates the nodes required to hold them.
+   *
+   * The preallocated nodes also bound the queue's memory: `try_enqueue` fails once they are all
+   * in use, e.g. because a stalled thread keeps them from being reclaimed, and dequeues from an
+   * empty queue claim no cells. Only `enqueue`, which ignores the capacity, and operations that
+   * have already claimed a cell allocate nodes beyond them.
+   *
+   * Besides the nodes holding the elements, one spare node per handle and the nodes retained
+   * by the reclamation policy are preallocated, i.e., `2 * max_threads` nodes with
+   * `hazard_reclaim`, so small bounded queues with many handles should use `eager_reclaim`.
+   */
+  basic_queue(
+      std::size_t max_threads,
+      ymc::capacity bound,
+      node_memory memory = node_memory::heap
+  ) : m_queue{ max_threads, bound, memory } {}
+  ~basic_queue() noexcept = default;
 
   /** Enqueues the given `elem` the queue's back. */
   void enqueue(pointer elem, std::size_t thread_id) {
     this->m_queue.enqueue(reinterpret_cast<void*>(elem), thread_id);
   }
 
+  /**
+   * Enqueues the given `elem` at the queue's back and returns true, unless the queue is bounded
+   * and full or all of its preallocated nodes are in use.
+   *
+   * The capacity is checked against the distance between the enqueue and the dequeue index, so
+   * concurrent calls may exceed it by one element per thread. `enqueue` ignores the capacity.
+   */
+  bool try_enqueue(pointer elem, std::size_t thread_id) {
+    return this->m_queue.try_enqueue(reinterpret_cast<void*>(elem), thread_id);
+  }
+
+  /** Returns the queue's capacity, `SIZE_MAX` if the queue is unbounded. */
+  std::size_t capacity() const noexcept {
+    return this->m_queue.capacity();
+  }
+
+  /** Claims an unused thread handle, which is released when the returned token is destroyed. */
+  [[nodiscard]] thread_handle acquire_handle() {
+    return thread_handle{ this->m_queue.registry(), this->m_queue.acquire_handle() };
+  }
+
+  /** Enqueues the given `elem` at the queue's back, using a handle claimed for the calling thread. */
+  void enqueue(pointer elem) {
+    this->enqueue(elem, this->m_queue.thread_local_handle());
+  }
+
+  /** Dequeues an element from the queue's front, using a handle claimed for the calling thread. */
+  pointer dequeue() {
+    return this->dequeue(this->m_queue.thread_local_handle());
+  }
+
+  /** Enqueues all `elems` in order at the queue's back. */
+  void enqueue_bulk(std::span<pointer> elems, std::size_t thread_id) {
+    this->m_queue.enqueue_bulk(
+        reinterpret_cast<void* const*>(elems.data()), elems.size(), thread_id);
+  }
+
   /** Dequeues an element from the queue's front. */
   pointer dequeue(size_t thread_id) {
     return reinterpret_cast<pointer>(this->m_queue.dequeue(thread_id));
   }
 
+  /**
+   * Dequeues an element from the queue's front, returns nullptr without claiming a cell if the
+   * queue appears empty, which makes polling an idle queue cheap.
+   */
+  pointer try_dequeue(std::size_t thread_id) {
+    return reinterpret_cast<pointer>(this->m_queue.try_dequeue(thread_id));
+  }
+
+  /**
+   * Returns the approximate number of elements in the queue, i.e., the distance between the
+   * enqueue and the dequeue index, which includes cells abandoned by failed fast-path attempts.
+   */
+  std::size_t size_approx() const noexcept {
+    return this->m_queue.size_approx();
+  }
+
+  /** Returns true if the queue appears empty. */
+  bool empty() const noexcept {
+    return this->m_queue.empty();
+  }
+
+  /**
+   * Dequeues an element from the queue's front, spinning briefly and then parking until one
+   * becomes available, returns nullptr only once the queue is closed and drained.
+   */
+  pointer dequeue_wait(std::size_t thread_id) {
+    return reinterpret_cast<pointer>(this->m_queue.dequeue_wait(thread_id));
+  }
+
+  /**
+   * Dequeues an element from the queue's front, waiting at most `timeout` for one to become
+   * available, returns nullptr on timeout or once the queue is closed and drained.
+   */
+  template <typename Rep, typename Period>
+  pointer try_dequeue_for(std::chrono::duration<Rep, Period> timeout, std::size_t thread_id) {
+    const auto ns = std::chrono::ceil<std::chrono::nanoseconds>(timeout);
+    return reinterpret_cast<pointer>(this->m_queue.try_dequeue_for(ns, thread_id));
+  }
+
+  /**
+   * Closes the queue and wakes all waiting consumers, no elements must be enqueued afterwards.
+   */
+  void close() noexcept {
+    this->m_queue.close();
+  }
+
+  /** Returns true if the queue has been closed. */
+  bool is_closed() const noexcept {
+    return this->m_queue.is_closed();
+  }
+
+  /**
+   * Dequeues up to `max` elements from the queue's front into `out` and returns the number of
+   * dequeued elements.
+   */
+  std::size_t dequeue_bulk(pointer* out, std::size_t max, std::size_t thread_id) {
+    return this->m_queue.dequeue_bulk(reinterpret_cast<void**>(out), max, thread_id);
+  }
+
+  /** Returns the hit/miss statistics of the queue's node pool. */
+  node_pool_stats pool_stats() const noexcept {
+    return this->m_queue.pool_stats();
+  }
+
+  /**
+   * Starts a background thread keeping at least `reserve` zeroed nodes in the node pool (up to its
+   * high watermark), so enqueuers and dequeuers never allocate nodes themselves.
+   */
+  void start_node_preparer(std::size_t reserve) {
+    this->m_queue.start_node_preparer(reserve);
+  }
+
+  /** Stops the background node preparer, if it is running. */
+  void stop_node_preparer() noexcept {
+    this->m_queue.stop_node_preparer();
+  }
+
+  /** Frees all nodes currently retained by the node pool and returns their number. */
+  std::size_t trim_pool() noexcept {
+    return this->m_queue.trim_pool();
+  }
+
+  /**
+   * Returns the approximate number of bytes of memory held by the queue, including its thread
+   * handles and all nodes, whether linked, held as spares or retained by the node pool. With
+   * `huge_pages` node memory, nodes are counted as the 2 MiB regions holding them.
+   */
+  std::size_t memory_footprint() const noexcept {
+    return this->m_queue.memory_footprint();
+  }
+
+  /**
+   * Returns a snapshot of the queue's operation counters and node memory, all counters are zero
+   * if the library is built with `YMC_QUEUE_STATS=0`.
+   */
+  queue_stats stats() const noexcept {
+    return this->m_queue.stats();
+  }
+
+  /**
+   * Returns the latency histograms of all operations (in timestamp counter ticks), separated by
+   * fast-path and slow-path completions, all histograms are empty unless the library is built
+   * with `YMC_QUEUE_LATENCY=1`.
+   */
+  queue_latencies latencies() const {
+    return this->m_queue.latencies();
+  }
+
   /** deleted copy/move constructors & assignment operators */
-  queue(const queue&)                  = delete;
-  queue(queue&&)                       = delete;
-  const queue& operator=(const queue&) = delete;
-  const queue& operator=(queue&&)      = delete;
+  basic_queue(const basic_queue&)                  = delete;
+  basic_queue(basic_queue&&)                       = delete;
+  const basic_queue& operator=(const basic_queue&) = delete;
+  const basic_queue& operator=(basic_queue&&)      = delete;
 };
+
+/** A queue with the default node size, patience and maximum number of thread handles. */
+template <typename T>
+using queue = basic_queue<T>;
 }
 
 #endif /* YMC_QUEUE_HPP */
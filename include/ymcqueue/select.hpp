@@ -0,0 +1,196 @@
+#ifndef YMC_SELECT_HPP
+#define YMC_SELECT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+
+namespace ymc {
+/** One of the queues of a select, together with the selecting thread's handle for it. */
+template <typename Q>
+struct select_source {
+  Q* queue;
+  std::size_t thread_id;
+};
+
+/** The element dequeued by a select and the index of the queue it was dequeued from. */
+template <typename T>
+struct select_result {
+  T* elem{ nullptr };
+  std::size_t index{ 0 };
+
+  /** Returns true if an element was dequeued. */
+  explicit operator bool() const noexcept {
+    return this->elem != nullptr;
+  }
+};
+
+/**
+ * Dequeues the first available element from any of several queues of type `Q`, which are
+ * checked in order, so earlier queues take priority.
+ *
+ * Each queue is checked for emptiness with two loads of its indices before a cell is claimed, so
+ * polling empty queues neither advances their indices nor allocates nodes. A blocking select parks
+ * on the wake-up words of all queues at once and is woken up by the first enqueue into any of
+ * them.
+ *
+ * A select holds the selecting thread's handle for each queue and must only be used by one thread
+ * at a time.
+ */
+template <typename Q>
+class select {
+  using pointer = typename Q::pointer;
+  using result_type = select_result<std::remove_pointer_t<pointer>>;
+
+  /** The number of emptiness checks of all queues before parking. */
+  static constexpr std::size_t SPIN_LIMIT = 128;
+
+  std::vector<select_source<Q>> m_sources;
+  /** The wake-up words of all queues and their values when last announcing to park. */
+  std::vector<std::atomic_uint32_t*> m_words;
+  std::vector<std::uint32_t> m_seqs;
+
+  /** Returns true if all queues have been closed. */
+  bool all_closed() const noexcept {
+    for (const auto& source : this->m_sources) {
+      if (!source.queue->m_queue.is_closed()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /** Dequeues from all queues in order, claiming cells even if they appear empty. */
+  result_type drain() {
+    for (std::size_t i = 0; i < this->m_sources.size(); ++i) {
+      auto& source = this->m_sources[i];
+      if (auto elem = source.queue->m_queue.dequeue(source.thread_id); elem != nullptr) {
+        return { reinterpret_cast<pointer>(elem), i };
+      }
+    }
+
+    return {};
+  }
+
+  result_type dequeue_until(std::optional<std::chrono::steady_clock::time_point> deadline) {
+    while (true) {
+      // spin briefly, without claiming cells while all queues appear empty
+      for (std::size_t spin = 0; spin < SPIN_LIMIT; ++spin) {
+        if (auto res = this->try_dequeue(); res) {
+          return res;
+        }
+
+        if (this->all_closed()) {
+          return this->drain();
+        }
+
+        detail::cpu_relax();
+      }
+
+      if (deadline.has_value() && std::chrono::steady_clock::now() >= *deadline) {
+        return {};
+      }
+
+      // announce the intent to park on every queue before checking for emptiness one final time
+      for (std::size_t i = 0; i < this->m_sources.size(); ++i) {
+        this->m_seqs[i] = this->m_sources[i].queue->m_queue.announce_select();
+      }
+
+      auto ready = this->all_closed();
+      for (const auto& source : this->m_sources) {
+        ready = ready || !source.queue->m_queue.empty();
+      }
+
+      if (!ready) {
+        detail::park_any(
+            this->m_words.data(), this->m_seqs.data(), this->m_words.size(), deadline);
+      }
+
+      for (const auto& source : this->m_sources) {
+        source.queue->m_queue.retract_select();
+      }
+    }
+  }
+
+public:
+  /** constructor & destructor */
+  select(std::initializer_list<select_source<Q>> sources) :
+    select(std::vector<select_source<Q>>{ sources })
+  {}
+
+  explicit select(std::vector<select_source<Q>> sources) :
+    m_sources{ std::move(sources) },
+    m_seqs(m_sources.size())
+  {
+    if (this->m_sources.empty() || this->m_sources.size() > detail::PARK_ANY_MAX) {
+      throw std::invalid_argument("selects require between 1 and 128 queues");
+    }
+
+    for (const auto& source : this->m_sources) {
+      if (source.queue == nullptr) {
+        throw std::invalid_argument("select source without queue");
+      }
+
+      this->m_words.push_back(&source.queue->m_queue.wake_word());
+    }
+  }
+
+  ~select() noexcept = default;
+
+  /**
+   * Dequeues an element from the first queue that does not appear empty, returns an empty result
+   * if all queues appear empty.
+   */
+  result_type try_dequeue() {
+    for (std::size_t i = 0; i < this->m_sources.size(); ++i) {
+      auto& source = this->m_sources[i];
+      if (auto elem = source.queue->m_queue.try_dequeue(source.thread_id); elem != nullptr) {
+        return { reinterpret_cast<pointer>(elem), i };
+      }
+    }
+
+    return {};
+  }
+
+  /**
+   * Dequeues an element from the first queue that does not appear empty, spinning briefly and
+   * then parking until an element is enqueued into any of the queues.
+   *
+   * Returns an empty result only once all queues have been closed and are drained.
+   */
+  result_type dequeue_wait() {
+    return this->dequeue_until(std::nullopt);
+  }
+
+  /**
+   * Dequeues an element like `dequeue_wait`, waiting at most `timeout`, returns an empty result on
+   * timeout or once all queues have been closed and are drained.
+   */
+  template <typename Rep, typename Period>
+  result_type try_dequeue_for(std::chrono::duration<Rep, Period> timeout) {
+    return this->dequeue_until(std::chrono::steady_clock::now() + timeout);
+  }
+
+  /** Returns the number of queues. */
+  std::size_t size() const noexcept {
+    return this->m_sources.size();
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  select(const select&)                  = delete;
+  select(select&&)                       = delete;
+  const select& operator=(const select&) = delete;
+  const select& operator=(select&&)      = delete;
+};
+}
+
+#endif /* YMC_SELECT_HPP */
@@ -0,0 +1,254 @@
+#ifndef YMC_SHARDED_QUEUE_HPP
+#define YMC_SHARDED_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+#include "private/numa.hpp"
+
+namespace ymc {
+/** How consumers of a sharded queue pick other shards once their own shard is empty. */
+enum class steal_policy {
+  /** Visit all other shards in order, starting after the consumer's own shard. */
+  round_robin,
+  /**
+   * Sample two random other shards and try the one with more elements first, then fall back to
+   * visiting the remaining shards in order.
+   */
+  two_choices,
+};
+
+/**
+ * A relaxed-FIFO MPMC queue of `T*` elements made up of several independent wait-free queues
+ * (shards), with `shards_per_node` shards per NUMA node, each specialized like a `basic_queue`.
+ *
+ * With `heap` node memory (the default), each shard's nodes are allocated wherever the allocating
+ * thread's memory policy places them. With `huge_pages` memory, they are allocated from an arena
+ * bound to the shard's NUMA node, which maps a 2 MiB region for every shard up front.
+ *
+ * The concurrency mode (`Mode`) applies to each shard. Since thread ids share home shards and
+ * consumers steal from other shards, modes other than `mpmc` require binding threads such that
+ * each shard has at most one producer (`spmc`) or consumer (`mpsc`) at any time, as required.
+ *
+ * Each thread id is bound to a home shard on the NUMA node it first operates on. Producers always
+ * enqueue into their home shard and consumers dequeue from their home shard first, stealing from
+ * other shards only if it appears empty. Elements enqueued by the same thread are dequeued in
+ * order, but there is no global order between elements of different producers. Each shard
+ * retains its wait-free guarantee, a `dequeue` visits every shard at most once.
+ */
+template <
+    typename T,
+    std::size_t NodeSize = detail::NODE_SIZE,
+    std::size_t Patience = detail::PATIENCE,
+    std::size_t MaxThreads = detail::MAX_THREADS,
+    typename Layout = padded_cells,
+    typename Reclaim = hazard_reclaim,
+    typename Mode = mpmc,
+    typename Backoff = no_backoff
+>
+class basic_sharded_queue {
+  using config_type = detail::queue_config_t<
+      NodeSize, Patience, MaxThreads, Layout, Reclaim, Mode, Backoff
+  >;
+  using shard_type = detail::erased_queue_t<config_type>;
+
+  /** Marks a thread id which has not yet been bound to a shard. */
+  static constexpr std::size_t UNBOUND = SIZE_MAX;
+
+  /** The sharding state of each thread id, padded to avoid false sharing between threads. */
+  struct alignas(64) thread_state_t {
+    /** The thread's home shard, `UNBOUND` until its first operation. */
+    std::atomic_size_t home{ UNBOUND };
+    /** The state of the thread's xorshift generator for sampling shards. */
+    std::uint64_t rng{ 0 };
+  };
+
+  /** The shards, grouped by NUMA node. */
+  std::vector<std::unique_ptr<shard_type>> m_shards;
+  std::size_t m_shards_per_node;
+  std::size_t m_max_threads;
+  steal_policy m_steal;
+  std::array<thread_state_t, MaxThreads> m_threads{};
+
+  /** Returns the home shard of the given thread, binding it on first use. */
+  std::size_t home_of(std::size_t thread_id) {
+    auto& state = this->m_threads[thread_id];
+    auto home = state.home.load(std::memory_order_relaxed);
+    if (home == UNBOUND) [[unlikely]] {
+      const auto nodes = this->m_shards.size() / this->m_shards_per_node;
+      const auto node = detail::current_numa_node() % nodes;
+      home = node * this->m_shards_per_node + thread_id % this->m_shards_per_node;
+      state.home.store(home, std::memory_order_relaxed);
+    }
+
+    return home;
+  }
+
+  /** Returns the next random number of the given thread's generator. */
+  std::uint64_t next_random(std::size_t thread_id) noexcept {
+    auto& x = this->m_threads[thread_id].rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+  }
+
+  /** Attempts to dequeue an element from any shard other than `home`. */
+  void* steal(std::size_t home, std::size_t thread_id) {
+    const auto count = this->m_shards.size();
+    // the offsets from the home shard of the sampled shards, 0 (the home shard) if none
+    std::size_t a = 0;
+    std::size_t b = 0;
+
+    if (this->m_steal == steal_policy::two_choices && count > 2) {
+      // sample two distinct offsets from the home shard in [1, count)
+      a = 1 + this->next_random(thread_id) % (count - 1);
+      b = 1 + this->next_random(thread_id) % (count - 2);
+      if (b >= a) {
+        b += 1;
+      }
+
+      auto& first = *this->m_shards[(home + a) % count];
+      auto& second = *this->m_shards[(home + b) % count];
+      const auto larger = first.size_approx() >= second.size_approx();
+      for (auto shard : { larger ? &first : &second, larger ? &second : &first }) {
+        if (auto elem = shard->try_dequeue(thread_id); elem != nullptr) {
+          return elem;
+        }
+      }
+    }
+
+    // visit the remaining shards in order, skipping the sampled ones
+    for (std::size_t i = 1; i < count; ++i) {
+      if (i == a || i == b) {
+        continue;
+      }
+
+      auto& shard = *this->m_shards[(home + i) % count];
+      if (auto elem = shard.try_dequeue(thread_id); elem != nullptr) {
+        return elem;
+      }
+    }
+
+    return nullptr;
+  }
+
+public:
+  using pointer = T*;
+  /** constructor & destructor */
+  explicit basic_sharded_queue(
+      std::size_t max_threads = MaxThreads,
+      std::size_t shards_per_node = 1,
+      steal_policy steal = steal_policy::two_choices,
+      node_memory memory = node_memory::heap
+  ) :
+    m_shards_per_node{ shards_per_node },
+    m_max_threads{ max_threads },
+    m_steal{ steal }
+  {
+    if (shards_per_node == 0) {
+      throw std::invalid_argument("shards_per_node must be at least 1");
+    }
+
+    const auto count = detail::numa_node_count() * shards_per_node;
+    this->m_shards.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto numa_node = static_cast<unsigned>(i / shards_per_node);
+      this->m_shards.push_back(
+          std::make_unique<shard_type>(max_threads, max_threads * 2, memory, numa_node));
+    }
+
+    for (std::size_t i = 0; i < MaxThreads; ++i) {
+      this->m_threads[i].rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+  }
+
+  ~basic_sharded_queue() noexcept = default;
+
+  /** Enqueues the given `elem` at the back of the calling thread's home shard. */
+  void enqueue(pointer elem, std::size_t thread_id) {
+    auto& shard = *this->m_shards[this->home_of(thread_id)];
+    shard.enqueue(reinterpret_cast<void*>(elem), thread_id);
+  }
+
+  /** Enqueues all `elems` in order at the back of the calling thread's home shard. */
+  void enqueue_bulk(std::span<pointer> elems, std::size_t thread_id) {
+    auto& shard = *this->m_shards[this->home_of(thread_id)];
+    shard.enqueue_bulk(reinterpret_cast<void* const*>(elems.data()), elems.size(), thread_id);
+  }
+
+  /**
+   * Dequeues an element from the front of the calling thread's home shard or, if it appears
+   * empty, from another shard, returns nullptr if all shards appear empty.
+   */
+  pointer dequeue(std::size_t thread_id) {
+    const auto home = this->home_of(thread_id);
+    if (auto elem = this->m_shards[home]->try_dequeue(thread_id); elem != nullptr) {
+      return reinterpret_cast<pointer>(elem);
+    }
+
+    return reinterpret_cast<pointer>(this->steal(home, thread_id));
+  }
+
+  /**
+   * Binds the given thread id to the given shard, which must happen before the thread's first
+   * operation, since rebinding a producer breaks the order of its elements.
+   */
+  void bind(std::size_t thread_id, std::size_t shard) {
+    if (thread_id >= this->m_max_threads || shard >= this->m_shards.size()) {
+      throw std::invalid_argument("invalid thread id or shard");
+    }
+
+    this->m_threads[thread_id].home.store(shard, std::memory_order_relaxed);
+  }
+
+  /** Returns the home shard of the given thread id, binding it to the calling thread's node. */
+  std::size_t home_shard(std::size_t thread_id) {
+    return this->home_of(thread_id);
+  }
+
+  /** Returns the number of shards. */
+  std::size_t shard_count() const noexcept {
+    return this->m_shards.size();
+  }
+
+  /** Returns the approximate number of elements in all shards. */
+  std::size_t size_approx() const noexcept {
+    std::size_t res = 0;
+    for (const auto& shard : this->m_shards) {
+      res += shard->size_approx();
+    }
+
+    return res;
+  }
+
+  /** Returns true if all shards appear empty. */
+  bool empty() const noexcept {
+    for (const auto& shard : this->m_shards) {
+      if (!shard->empty()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  basic_sharded_queue(const basic_sharded_queue&)                  = delete;
+  basic_sharded_queue(basic_sharded_queue&&)                       = delete;
+  const basic_sharded_queue& operator=(const basic_sharded_queue&) = delete;
+  const basic_sharded_queue& operator=(basic_sharded_queue&&)      = delete;
+};
+
+/** A sharded queue with the default node size, patience and maximum number of thread handles. */
+template <typename T>
+using sharded_queue = basic_sharded_queue<T>;
+}
+
+#endif /* YMC_SHARDED_QUEUE_HPP */
@@ -0,0 +1,238 @@
+#ifndef YMC_VALUE_QUEUE_HPP
+#define YMC_VALUE_QUEUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <span>
+
+#include "ymcqueue/queue.hpp"
+#include "private/value_encoding.hpp"
+
+namespace ymc {
+/**
+ * A wait-free MPMC queue storing trivially copyable values of at most pointer size inline in its
+ * cells, instead of transporting pointers to them.
+ *
+ * For pointer-sized `T`, the two values whose bit patterns have all bits set except for (at most)
+ * the least significant one are reserved and can not be enqueued. Apart from transporting values,
+ * the queue and its template parameters behave like `basic_queue`.
+ */
+template <
+    typename T,
+    std::size_t NodeSize = detail::NODE_SIZE,
+    std::size_t Patience = detail::PATIENCE,
+    std::size_t MaxThreads = detail::MAX_THREADS,
+    typename Layout = padded_cells,
+    typename Reclaim = hazard_reclaim,
+    typename Mode = mpmc,
+    typename Backoff = no_backoff
+>
+class basic_value_queue {
+  static_assert(
+      detail::is_inline_value_v<T>,
+      "value queues require trivially copyable types of at most pointer size"
+  );
+
+  using config_type = detail::queue_config_t<
+      NodeSize, Patience, MaxThreads, Layout, Reclaim, Mode, Backoff
+  >;
+  /** The number of values encoded/decoded at once by bulk operations. */
+  static constexpr std::size_t BULK_CHUNK = 64;
+  /** the internal queue representation */
+  detail::erased_queue_t<config_type> m_queue;
+public:
+  using value_type = T;
+  /** constructor & destructor */
+  explicit basic_value_queue(std::size_t max_threads = MaxThreads) : m_queue{ max_threads } {}
+  /** Constructs a queue whose node pool retains at most `pool_high_watermark` reclaimed nodes. */
+  basic_value_queue(
+      std::size_t max_threads,
+      std::size_t pool_high_watermark,
+      node_memory memory = node_memory::heap
+  ) : m_queue{ max_threads, pool_high_watermark, memory } {}
+  /** Constructs a bounded queue, which preallocates its nodes like a bounded `basic_queue`. */
+  basic_value_queue(
+      std::size_t max_threads,
+      ymc::capacity bound,
+      node_memory memory = node_memory::heap
+  ) : m_queue{ max_threads, bound, memory } {}
+  ~basic_value_queue() noexcept = default;
+
+  /** Enqueues the given `value` at the queue's back, throws if `value` is reserved. */
+  void enqueue(T value, std::size_t thread_id) {
+    this->m_queue.enqueue(detail::encode_value(value), thread_id);
+  }
+
+  /**
+   * Enqueues the given `value` at the queue's back and returns true, unless the queue is bounded
+   * and full or all of its preallocated nodes are in use, throws if `value` is reserved.
+   */
+  bool try_enqueue(T value, std::size_t thread_id) {
+    return this->m_queue.try_enqueue(detail::encode_value(value), thread_id);
+  }
+
+  /** Returns the queue's capacity, `SIZE_MAX` if the queue is unbounded. */
+  std::size_t capacity() const noexcept {
+    return this->m_queue.capacity();
+  }
+
+  /** Enqueues the given `value` at the queue's back, using a handle claimed for the calling thread. */
+  void enqueue(T value) {
+    this->enqueue(value, this->m_queue.thread_local_handle());
+  }
+
+  /** Dequeues a value from the queue's front, returns an empty optional if the queue is empty. */
+  std::optional<T> dequeue(std::size_t thread_id) {
+    return detail::decode_value<T>(this->m_queue.dequeue(thread_id));
+  }
+
+  /** Dequeues a value from the queue's front, using a handle claimed for the calling thread. */
+  std::optional<T> dequeue() {
+    return this->dequeue(this->m_queue.thread_local_handle());
+  }
+
+  /** Claims an unused thread handle, which is released when the returned token is destroyed. */
+  [[nodiscard]] thread_handle acquire_handle() {
+    return thread_handle{ this->m_queue.registry(), this->m_queue.acquire_handle() };
+  }
+
+  /**
+   * Enqueues all `values` in order at the queue's back, throws if any value is reserved, in which
+   * case no value of the chunk of up to 64 values containing it is enqueued.
+   */
+  void enqueue_bulk(std::span<const T> values, std::size_t thread_id) {
+    std::array<void*, BULK_CHUNK> encoded;
+    while (!values.empty()) {
+      const auto n = std::min(values.size(), BULK_CHUNK);
+      for (std::size_t i = 0; i < n; ++i) {
+        encoded[i] = detail::encode_value(values[i]);
+      }
+
+      this->m_queue.enqueue_bulk(encoded.data(), n, thread_id);
+      values = values.subspan(n);
+    }
+  }
+
+  /**
+   * Dequeues up to `max` values from the queue's front into `out` and returns the number of
+   * dequeued values.
+   */
+  std::size_t dequeue_bulk(T* out, std::size_t max, std::size_t thread_id) {
+    std::array<void*, BULK_CHUNK> encoded;
+    std::size_t count = 0;
+    while (count < max) {
+      const auto requested = std::min(max - count, BULK_CHUNK);
+      const auto n = this->m_queue.dequeue_bulk(encoded.data(), requested, thread_id);
+      for (std::size_t i = 0; i < n; ++i) {
+        out[count++] = *detail::decode_value<T>(encoded[i]);
+      }
+
+      if (n < requested) {
+        break;
+      }
+    }
+
+    return count;
+  }
+
+  /**
+   * Dequeues a value from the queue's front, returns an empty optional without claiming a cell if
+   * the queue appears empty.
+   */
+  std::optional<T> try_dequeue(std::size_t thread_id) {
+    return detail::decode_value<T>(this->m_queue.try_dequeue(thread_id));
+  }
+
+  /** Returns the approximate number of values in the queue. */
+  std::size_t size_approx() const noexcept {
+    return this->m_queue.size_approx();
+  }
+
+  /** Returns true if the queue appears empty. */
+  bool empty() const noexcept {
+    return this->m_queue.empty();
+  }
+
+  /**
+   * Dequeues a value from the queue's front, spinning briefly and then parking until one becomes
+   * available, returns an empty optional only once the queue is closed and drained.
+   */
+  std::optional<T> dequeue_wait(std::size_t thread_id) {
+    return detail::decode_value<T>(this->m_queue.dequeue_wait(thread_id));
+  }
+
+  /**
+   * Dequeues a value from the queue's front, waiting at most `timeout` for one to become available,
+   * returns an empty optional on timeout or once the queue is closed and drained.
+   */
+  template <typename Rep, typename Period>
+  std::optional<T> try_dequeue_for(
+      std::chrono::duration<Rep, Period> timeout,
+      std::size_t thread_id
+  ) {
+    const auto ns = std::chrono::ceil<std::chrono::nanoseconds>(timeout);
+    return detail::decode_value<T>(this->m_queue.try_dequeue_for(ns, thread_id));
+  }
+
+  /**
+   * Closes the queue and wakes all waiting consumers, no values must be enqueued afterwards.
+   */
+  void close() noexcept {
+    this->m_queue.close();
+  }
+
+  /** Returns true if the queue has been closed. */
+  bool is_closed() const noexcept {
+    return this->m_queue.is_closed();
+  }
+
+  /** Returns the hit/miss statistics of the queue's node pool. */
+  node_pool_stats pool_stats() const noexcept {
+    return this->m_queue.pool_stats();
+  }
+
+  /** Starts a background node preparer, see `basic_queue::start_node_preparer`. */
+  void start_node_preparer(std::size_t reserve) {
+    this->m_queue.start_node_preparer(reserve);
+  }
+
+  /** Stops the background node preparer, if it is running. */
+  void stop_node_preparer() noexcept {
+    this->m_queue.stop_node_preparer();
+  }
+
+  /** Frees all nodes currently retained by the node pool and returns their number. */
+  std::size_t trim_pool() noexcept {
+    return this->m_queue.trim_pool();
+  }
+
+  /** Returns the approximate memory held by the queue, see `basic_queue::memory_footprint`. */
+  std::size_t memory_footprint() const noexcept {
+    return this->m_queue.memory_footprint();
+  }
+
+  /** Returns a snapshot of the queue's operation counters and node memory. */
+  queue_stats stats() const noexcept {
+    return this->m_queue.stats();
+  }
+
+  /** Returns the latency histograms of all operations, see `basic_queue::latencies`. */
+  queue_latencies latencies() const {
+    return this->m_queue.latencies();
+  }
+
+  /** deleted copy/move constructors & assignment operators */
+  basic_value_queue(const basic_value_queue&)                  = delete;
+  basic_value_queue(basic_value_queue&&)                       = delete;
+  const basic_value_queue& operator=(const basic_value_queue&) = delete;
+  const basic_value_queue& operator=(basic_value_queue&&)      = delete;
+};
+
+/** A value queue with the default node size, patience and maximum number of thread handles. */
+template <typename T>
+using value_queue = basic_value_queue<T>;
+}
+
+#endif /* YMC_VALUE_QUEUE_HPP */
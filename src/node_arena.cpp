@@ -0,0 +1,172 @@
+#include "private/node_arena.hpp"
+#include "private/numa.hpp"
+
+#include <cassert>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ymc::detail {
+namespace {
+#if defined(__linux__)
+/** The `MPOL_PREFERRED` memory policy, defined here to avoid depending on libnuma headers. */
+constexpr int MPOL_PREFERRED_ = 1;
+
+/** Maps a `size` byte region aligned to `size`, preferably backed by huge pages. */
+std::byte* map_aligned(std::size_t size) {
+  constexpr auto prot = PROT_READ | PROT_WRITE;
+  constexpr auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+  // explicit huge pages are always aligned to their size
+  auto ptr = mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+  if (ptr != MAP_FAILED) {
+    return static_cast<std::byte*>(ptr);
+  }
+
+  // fall back to transparent huge pages, over-allocate to align the region manually
+  ptr = mmap(nullptr, 2 * size, prot, flags, -1, 0);
+  if (ptr == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+  const auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+  const auto aligned = (addr + size - 1) & ~(size - 1);
+  if (aligned > addr) {
+    munmap(ptr, aligned - addr);
+  }
+  if (aligned + size < addr + 2 * size) {
+    munmap(reinterpret_cast<void*>(aligned + size), addr + 2 * size - (aligned + size));
+  }
+
+  madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+  return reinterpret_cast<std::byte*>(aligned);
+}
+
+/** Binds the given region to the given NUMA node, on a best effort basis. */
+void bind_region(std::byte* base, std::size_t size, unsigned numa_node) {
+  constexpr auto max_nodes = sizeof(unsigned long) * 8;
+  if (numa_node >= max_nodes) {
+    return;
+  }
+
+  // the kernel reads `maxnode - 1` bits of the mask, so one more than the mask's width is passed
+  const unsigned long mask = 1ul << numa_node;
+  syscall(SYS_mbind, base, size, MPOL_PREFERRED_, &mask, max_nodes + 1, 0);
+}
+
+/** Returns the region's memory to the OS, subsequent accesses fault in zeroed pages. */
+void release_region(std::byte* base, std::size_t size) {
+  madvise(base, size, MADV_DONTNEED);
+}
+
+void unmap_region(std::byte* base, std::size_t size) {
+  munmap(base, size);
+}
+#else
+std::byte* map_aligned(std::size_t size) {
+  return static_cast<std::byte*>(::operator new(size, std::align_val_t{ size }));
+}
+
+void bind_region(std::byte*, std::size_t, unsigned) {}
+
+void release_region(std::byte*, std::size_t) {}
+
+void unmap_region(std::byte* base, std::size_t size) {
+  ::operator delete(base, std::align_val_t{ size });
+}
+#endif
+}
+
+node_arena_t::node_arena_t(std::size_t node_size, std::optional<unsigned> numa_node):
+  m_node_size{ node_size }, m_nodes_per_region{ REGION_SIZE / node_size }, m_numa_node{ numa_node }
+{
+  if (this->m_nodes_per_region == 0) {
+    throw std::invalid_argument("nodes must fit into a single region");
+  }
+}
+
+node_arena_t::~node_arena_t() noexcept {
+  for (auto& [_ignore, region] : this->m_regions) {
+    unmap_region(region->base, REGION_SIZE);
+  }
+}
+
+void* node_arena_t::allocate() {
+  const auto numa_node = this->m_numa_node.has_value() ? *this->m_numa_node : current_numa_node();
+  void* slot = nullptr;
+
+  {
+    std::lock_guard lock{ this->m_mutex };
+    region_t* region = nullptr;
+    // find a local region with a free slot
+    for (auto& [_ignore, candidate] : this->m_regions) {
+      if (
+          candidate->numa_node == numa_node
+          && (candidate->free_list != nullptr || candidate->bump < this->m_nodes_per_region)
+      ) {
+        region = candidate.get();
+        break;
+      }
+    }
+
+    if (region == nullptr) {
+      region = &this->map_region(numa_node);
+    }
+
+    if (region->free_list != nullptr) {
+      slot = region->free_list;
+      region->free_list = region->free_list->next;
+    } else {
+      slot = region->base + region->bump * this->m_node_size;
+      region->bump += 1;
+    }
+
+    if (region->live == 0) {
+      this->m_resident.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    region->live += 1;
+  }
+
+  return slot;
+}
+
+void node_arena_t::deallocate(void* node) noexcept {
+  const auto addr = reinterpret_cast<std::uintptr_t>(node);
+
+  std::lock_guard lock{ this->m_mutex };
+  const auto it = this->m_regions.find(addr & ~(REGION_SIZE - 1));
+  assert(it != this->m_regions.end() && "node not allocated from this arena");
+  auto& region = *it->second;
+
+  region.live -= 1;
+  if (region.live == 0) {
+    // the region is idle, return its memory but retain the mapping
+    release_region(region.base, REGION_SIZE);
+    region.free_list = nullptr;
+    region.bump = 0;
+    this->m_resident.fetch_sub(1, std::memory_order_relaxed);
+  } else {
+    auto slot = ::new (node) free_slot_t{ region.free_list };
+    region.free_list = slot;
+  }
+}
+
+node_arena_t::region_t& node_arena_t::map_region(unsigned numa_node) {
+  auto base = map_aligned(REGION_SIZE);
+  bind_region(base, REGION_SIZE, numa_node);
+
+  auto region = std::make_unique<region_t>();
+  region->base = base;
+  region->numa_node = numa_node;
+
+  auto& res = *region;
+  this->m_regions.emplace(reinterpret_cast<std::uintptr_t>(base), std::move(region));
+  return res;
+}
+}
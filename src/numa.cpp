@@ -0,0 +1,54 @@
+#include "private/numa.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ymc::detail {
+#if defined(__linux__)
+unsigned current_numa_node() noexcept {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+
+  return node;
+}
+
+std::size_t numa_node_count() noexcept {
+  static const std::size_t count = [] {
+    // online nodes are numbered densely, so the highest node id determines the count
+    std::size_t nodes = 0;
+    std::error_code ec{};
+    for (const auto& entry : std::filesystem::directory_iterator{ "/sys/devices/system/node", ec }) {
+      const auto name = entry.path().filename().string();
+      const auto is_node = name.size() > 4
+          && name.starts_with("node")
+          && name.find_first_not_of("0123456789", 4) == std::string::npos;
+      if (is_node) {
+        nodes = std::max<std::size_t>(nodes, std::stoul(name.substr(4)) + 1);
+      }
+    }
+
+    return nodes == 0 ? std::size_t{ 1 } : nodes;
+  }();
+
+  return count;
+}
+#else
+unsigned current_numa_node() noexcept {
+  return 0;
+}
+
+std::size_t numa_node_count() noexcept {
+  return 1;
+}
+#endif
+}
@@ -0,0 +1,91 @@
+#ifndef YMC_QUEUE_BACKOFF_HPP
+#define YMC_QUEUE_BACKOFF_HPP
+
+#include <cstdint>
+
+#include "private/parking.hpp"
+
+namespace ymc::detail {
+/**
+ * The backoff policy of the original C++ port: dequeuers poison empty cells immediately and
+ * fast-path attempts are retried back to back.
+ *
+ * Each policy maps a per-handle state word, which it updates with the outcome of every fast-path
+ * attempt, to the number of `pause` iterations to wait for a late enqueuer to fill a cell before
+ * poisoning it and to wait between failed fast-path attempts.
+ */
+struct no_backoff_t {
+  /** The initial state of each handle. */
+  static constexpr std::uint32_t INITIAL = 0;
+
+  /** Records the outcome of a fast-path attempt. */
+  static constexpr void record(std::uint32_t&, bool) noexcept {}
+
+  /** Returns the number of `pause` iterations to wait for. */
+  static constexpr std::uint32_t spins(std::uint32_t) noexcept {
+    return 0;
+  }
+};
+
+/**
+ * Waits for `Spins` `pause` iterations, like the `MAX_SPIN` wait of the original C implementation,
+ * regardless of contention.
+ */
+template <std::uint32_t Spins>
+struct fixed_backoff_t {
+  static constexpr std::uint32_t INITIAL = 0;
+
+  static constexpr void record(std::uint32_t&, bool) noexcept {}
+
+  static constexpr std::uint32_t spins(std::uint32_t) noexcept {
+    return Spins;
+  }
+};
+
+/**
+ * Waits for up to `MaxSpins` `pause` iterations, in proportion to the handle's recent rate of
+ * failed fast-path attempts, so uncontended handles do not wait at all.
+ *
+ * The state is an exponentially weighted moving average of the failure rate in 1/1024ths, each
+ * attempt contributing 1/8th.
+ */
+template <std::uint32_t MaxSpins>
+struct adaptive_backoff_t {
+  static constexpr std::uint32_t INITIAL = 0;
+  static constexpr std::uint32_t ONE = 1024;
+
+  static constexpr void record(std::uint32_t& rate, bool failed) noexcept {
+    rate = failed ? rate + ((ONE - rate) >> 3) : rate - (rate >> 3);
+  }
+
+  static constexpr std::uint32_t spins(std::uint32_t rate) noexcept {
+    return static_cast<std::uint32_t>(std::uint64_t{ MaxSpins } * rate / ONE);
+  }
+};
+
+/** Spins on `pause` for the given number of iterations. */
+inline void spin(std::uint32_t spins) noexcept {
+  for (std::uint32_t i = 0; i < spins; ++i) {
+    cpu_relax();
+  }
+}
+
+/**
+ * Spins on `pause` for the given number of iterations or until `done` returns true, returns
+ * whether it did.
+ */
+template <typename F>
+bool spin_until(std::uint32_t spins, F&& done) noexcept {
+  for (std::uint32_t i = 0; i < spins; ++i) {
+    if (done()) {
+      return true;
+    }
+
+    cpu_relax();
+  }
+
+  return false;
+}
+}
+
+#endif /* YMC_QUEUE_BACKOFF_HPP */
@@ -4,9 +4,54 @@
 #include <atomic>
 #include <cstdint>
 
+#include "private/backoff.hpp"
+
 namespace ymc::detail {
-/** The size of each node's cell array. */
+/** The default size of each node's cell array. */
 constexpr std::size_t NODE_SIZE = 1024;
+/** The default number of fast-path attempts before falling back to the slow-path. */
+constexpr std::size_t PATIENCE = 10;
+/** The default maximum number of thread handles per queue. */
+constexpr std::size_t MAX_THREADS = 128;
+/** The maximum number of elements a bounded queue accepts through `try_enqueue`. */
+struct capacity_t {
+  std::size_t elements;
+};
+/**
+ * The concurrency mode of a queue, i.e., whether at most one thread enqueues and/or at most one
+ * thread dequeues at any time.
+ */
+template <bool SingleProducer, bool SingleConsumer>
+struct concurrency_mode_t {
+  static constexpr bool SINGLE_PRODUCER = SingleProducer;
+  static constexpr bool SINGLE_CONSUMER = SingleConsumer;
+};
+/** The compile-time configuration of a queue engine. */
+template <
+    std::size_t NodeSize,
+    std::size_t Patience,
+    std::size_t MaxThreads,
+    typename Layout,
+    typename Reclaim,
+    typename Mode = concurrency_mode_t<false, false>,
+    typename Backoff = no_backoff_t
+>
+struct queue_config_t {
+  /** The number of cells per node. */
+  static constexpr std::size_t NODE_SIZE = NodeSize;
+  /** The number of fast-path attempts before falling back to the slow-path. */
+  static constexpr std::size_t PATIENCE = Patience;
+  /** The maximum number of thread handles. */
+  static constexpr std::size_t MAX_THREADS = MaxThreads;
+  /** The layout policy of each node's cells. */
+  using layout_type = Layout;
+  /** The memory reclamation policy. */
+  using reclaim_type = Reclaim;
+  /** The concurrency mode. */
+  using mode_type = Mode;
+  /** The backoff policy for contended cells and fast-path retries. */
+  using backoff_type = Backoff;
+};
 /** A enqueue request. */
 struct alignas(64) enq_req_t {
   std::atomic_intmax_t id;
@@ -1,58 +1,1760 @@
 #ifndef YMC_ERASED_QUEUE_HPP
 #define YMC_ERASED_QUEUE_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <initializer_list>
 #include <limits>
-#include <vector>
-#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
 
+#include "private/detail.hpp"
 #include "private/handle.hpp"
+#include "private/latency.hpp"
+#include "private/node.hpp"
+#include "private/node_directory.hpp"
+#include "private/node_pool.hpp"
+#include "private/parking.hpp"
+#include "private/reclaim.hpp"
+#include "private/registry.hpp"
+#include "private/stats.hpp"
 
 namespace ymc::detail {
-struct cell_t;
-struct node_t;
+inline constexpr auto relaxed = std::memory_order_relaxed;
+inline constexpr auto acquire = std::memory_order_acquire;
+inline constexpr auto release = std::memory_order_release;
+inline constexpr auto seq_cst = std::memory_order_seq_cst;
 
+template <typename Node>
+struct find_cell_result_t {
+  cell_ref_t cell;
+  Node& curr;
+};
+
+template<typename T>
+constexpr T* top_ptr() {
+  return reinterpret_cast<T*>(std::numeric_limits<std::uintmax_t>::max());
+}
+
+/** The number of most recently linked nodes resolved by the node directory. */
+inline constexpr std::size_t NODE_DIRECTORY_SLOTS = 1024;
+
+/** Check the given peer's current hazard node id and return the matching node pointer. */
+template <typename Node, typename Directory>
+Node* check(
+    const std::atomic_uintmax_t& peer_hzd_node_id,
+    Node* curr,
+    Node* old,
+    Directory& directory
+) {
+  // read the peer's current hazard node id
+  const auto hzd_node_id = peer_hzd_node_id.load(acquire);
+  // the peer's hazard id lags behind the current node
+  if (hzd_node_id < curr->id) {
+    // all nodes between old and curr are live, so the hazard node is returned if it is published
+    const auto hzd = static_cast<std::intmax_t>(hzd_node_id);
+    if (hzd >= old->id) {
+      if (auto node = directory.find(hzd); node != nullptr) {
+        return node;
+      }
+    }
+
+    auto tmp = old;
+    // advance curr until the first node protected by the peer
+    while (tmp->id < hzd_node_id) {
+      tmp = tmp->next;
+    }
+    curr = tmp;
+  }
+
+  return curr;
+}
+
+/** Advances a peer thread's head/tail pointer */
+template <typename Node, typename Directory>
+Node* update(
+    std::atomic<Node*>& peer_node,
+    const std::atomic_uintmax_t& peer_hzd_node_id,
+    Node* curr,
+    Node* old,
+    Directory& directory
+) {
+  // check the peer's current node pointer
+  auto node = peer_node.load(acquire);
+  // if the peer is lagging behind, update the pointer
+  if (node->id < curr->id) {
+    if (!peer_node.compare_exchange_strong(node, curr, seq_cst, seq_cst)) {
+      if (node->id < curr->id) {
+        curr = node;
+      }
+    }
+
+    curr = check(peer_hzd_node_id, curr, old, directory);
+  }
+
+  return curr;
+}
+
+/**
+ * Returns the successor of `curr`, installing the thread's spare node if there is none yet and
+ * publishing it in the directory.
+ */
+template <typename Node, typename Directory>
+Node* link_next(
+    Node& curr,
+    handle_t<Node>& thread_handle,
+    node_pool_t<Node>& pool,
+    Directory& directory
+) {
+  auto next = curr.next.load(relaxed);
+  if (next != nullptr) {
+    return next;
+  }
+
+  auto tmp = thread_handle.spare_node;
+  // use the current spare node if there is one
+  if (tmp == nullptr) {
+    tmp = pool.acquire();
+    thread_handle.spare_node = tmp;
+    thread_handle.counters.add(counter_t::nodes_allocated);
+    thread_handle.counters.set(counter_t::spare_nodes, 1);
+  }
+  // set the appropriate node id
+  tmp->id = curr.id + 1;
+  // attempt to install it and proceed
+  if (curr.next.compare_exchange_strong(next, tmp, release, acquire)) {
+    next = tmp;
+    directory.publish(tmp);
+    thread_handle.spare_node = nullptr;
+    thread_handle.counters.set(counter_t::spare_nodes, 0);
+  }
+
+  return next;
+}
+
+/** Searches for the node & cell matching the given idx value. */
+template <typename Node, typename Directory>
+find_cell_result_t<Node> find_cell(
+    const std::atomic<Node*>& ptr,
+    handle_t<Node>& thread_handle,
+    node_pool_t<Node>& pool,
+    Directory& directory,
+    std::intmax_t idx
+) {
+  auto curr = ptr.load(relaxed);
+  const auto target = Node::node_id_of(idx);
+  // skip the walk if the node is more than one step ahead and already linked
+  if (target > curr->id + 1) {
+    if (auto node = directory.find(target); node != nullptr) {
+      return { node->cells[Node::cell_of(idx)], *node };
+    }
+  }
+
+  // search the node containing the cell for the idx value, installing new nodes as required
+  for (auto j = curr->id; j < target; ++j) {
+    curr = link_next(*curr, thread_handle, pool, directory);
+  }
+  // return both the cell and the node pointer (reference)
+  return { curr->cells[Node::cell_of(idx)], *curr };
+}
+
+/**
+ * The type-erased queue engine, which transports `void*` elements.
+ *
+ * The engine is header-only and specialized at compile time by its `queue_config_t` for the number
+ * of cells per node, the number of fast-path attempts, the maximum number of thread handles, the
+ * layout of each node's cells, the reclamation policy, the concurrency mode and the backoff policy.
+ */
+template <typename Config>
 class erased_queue_t {
-  static constexpr auto PATIENCE  = std::size_t{ 10 };
+  static constexpr auto NODE_SIZE   = Config::NODE_SIZE;
+  static constexpr auto PATIENCE    = Config::PATIENCE;
+  static constexpr auto MAX_THREADS = Config::MAX_THREADS;
+
+  static_assert(MAX_THREADS > 0, "queues require at least one thread handle");
+  static_assert(
+      !(Config::reclaim_type::BACKGROUND && Config::reclaim_type::EPOCH),
+      "epoch-based reclamation is run by dequeuers"
+  );
+
+  using node_type    = node_t<NODE_SIZE, typename Config::layout_type>;
+  using reclaim_type = typename Config::reclaim_type;
+  using backoff_type = typename Config::backoff_type;
+  using handle_type  = handle_t<node_type>;
+
   static constexpr auto NO_HAZARD = std::numeric_limits<std::uintmax_t>::max();
-  /** memory reclamation */
-  void cleanup(handle_t& th);
+  /** The epoch announced by handles outside of operations with epoch-based reclamation. */
+  static constexpr auto NO_EPOCH = std::numeric_limits<std::uint64_t>::max();
+  /** The number of emptiness checks a waiting consumer spins for before parking. */
+  static constexpr auto SPIN_LIMIT = std::size_t{ 128 };
+  /** The increment of `m_waiters` for each consumer parked in a select over several queues. */
+  static constexpr auto SELECT_WAITER = std::uint32_t{ 1 } << 16;
+  /** The capacity of unbounded queues. */
+  static constexpr auto UNBOUNDED = std::numeric_limits<std::size_t>::max();
+  /**
+   * The position of the cell whose enqueuer links the next node ahead of time, so enqueuers
+   * crossing the node boundary find it already prepared.
+   */
+  static constexpr auto PRELINK_CELL = NODE_SIZE - std::max<std::size_t>(1, NODE_SIZE / 8);
+  /** The interval in which the background preparer refills the node pool. */
+  static constexpr auto PREPARER_INTERVAL = std::chrono::microseconds{ 50 };
+  /** Whether operation latencies are recorded. */
+  static constexpr bool LATENCY = YMC_QUEUE_LATENCY != 0;
+  /** Whether at most one thread enqueues or dequeues at any time, respectively. */
+  static constexpr bool SINGLE_PRODUCER = Config::mode_type::SINGLE_PRODUCER;
+  static constexpr bool SINGLE_CONSUMER = Config::mode_type::SINGLE_CONSUMER;
+  /** memory reclamation & node preparation */
+  void protect(handle_type& th, std::uintmax_t node_id) noexcept;
+  void unprotect(handle_type& th) noexcept;
+  void cleanup(handle_type& th);
+  std::uint64_t reclaim_locked(std::intmax_t oid, node_type* new_node, handle_type& first);
+  std::uint64_t retire_locked(std::intmax_t oid, node_type* new_node, handle_type& first);
+  std::uint64_t background_cleanup();
+  void refill_spare(handle_type& th);
+  void replenish(handle_type& th);
+  /** latency recording */
+  std::uint64_t start_timing(handle_type& th);
+  void prelink(std::intmax_t idx, node_type& curr, handle_type& th);
+  /** blocking dequeue helpers */
+  bool  maybe_empty() const noexcept;
+  void  wake_waiters() noexcept;
+  void* dequeue_until(
+      std::size_t thread_id,
+      std::optional<std::chrono::steady_clock::time_point> deadline
+  );
   /** enqueue sub-procedures and helper */
-  bool  enq_fast(void* elem, handle_t& thread_handle, std::intmax_t& id);
-  void  enq_slow(void* elem, handle_t& thread_handle, std::intmax_t id);
-  void* help_enq(cell_t& c,  handle_t& thread_handle, std::intmax_t node_id);
+  bool  enq(void* elem, handle_type& thread_handle);
+  bool  enq_fast(void* elem, handle_type& thread_handle, std::intmax_t& id);
+  void  enq_slow(void* elem, handle_type& thread_handle, std::intmax_t id);
+  void* help_enq(cell_ref_t c, handle_type& thread_handle, std::intmax_t node_id);
   /** dequeue sub-procedures and helper */
-  void* deq_fast(handle_t& th, std::intmax_t& id);
-  void* deq_slow(handle_t& th, std::intmax_t id);
-  void  help_deq(handle_t& th, handle_t& ph);
+  std::intmax_t claim_deq_idx(std::intmax_t count) noexcept;
+  bool  claim_cell(cell_ref_t c) noexcept;
+  void* deq(handle_type& th, bool& fast);
+  void* deq_fast(handle_type& th, std::intmax_t& id);
+  void* deq_slow(handle_type& th, std::intmax_t id);
+  void  help_deq(handle_type& th, handle_type& ph);
+  /** handle registration, must be called with the registry mutex held */
+  std::size_t acquire_handle_locked();
+  void release_handle_locked(std::size_t thread_id);
+  void ring_insert(handle_type& th);
+  void ring_remove(handle_type& th);
 
   /** Index of the next position for enqueue. */
   alignas(128) std::atomic_intmax_t m_enq_idx{ 1 };
   /** Index of the next position for dequeue. */
   alignas(128) std::atomic_intmax_t m_deq_idx{ 1 };
+  /** The handle of the last producer entering the slow path, used only with a single producer. */
+  alignas(128) std::atomic<handle_type*> m_producer{ nullptr };
   /** Index of the head of the queue. */
   alignas(128) std::atomic_intmax_t m_help_idx{ 0 };
+  /**
+   * Number of consumers currently parked (or about to park) in a blocking dequeue, consumers
+   * parked in a select count `SELECT_WAITER` each.
+   */
+  alignas(128) std::atomic_uint32_t m_waiters{ 0 };
+  /** Futex word, which is incremented whenever parked consumers are woken up. */
+  std::atomic_uint32_t m_wake_seq{ 0 };
+  /** Whether the queue has been closed. */
+  std::atomic_bool m_closed{ false };
   /** Pointer to the head node of the queue. */
-  std::atomic<node_t*> m_head;
-  /** Vector of all thread handles */
-  std::deque<handle_t> m_handles;
+  alignas(128) std::atomic<node_type*> m_head;
+  /** The global epoch, advanced by cleanup with epoch-based reclamation. */
+  alignas(128) std::atomic_uint64_t m_epoch{ 0 };
+  /**
+   * The oldest node unlinked by cleanup but not yet returned to the pool with epoch-based
+   * reclamation, all retired nodes are still linked up to the head, nullptr if there are none.
+   */
+  node_type* m_retired{ nullptr };
+  /**
+   * The epochs in which the retired nodes were unlinked and the first node after each range,
+   * oldest first, there are at most two, since the epoch advances at most once per cleanup.
+   */
+  std::array<std::pair<std::uint64_t, node_type*>, 2> m_retired_ranges{};
+  std::size_t m_retired_count{ 0 };
+  /** Pool of reclaimed nodes for reuse. */
+  node_pool_t<node_type> m_node_pool;
+  /** Directory of the most recently linked nodes, for O(1) lookups by node id. */
+  node_directory_t<node_type, NODE_DIRECTORY_SLOTS> m_directory{};
+  /** Array of all `m_max_threads` thread handles, sized at runtime rather than by `MAX_THREADS`. */
+  std::unique_ptr<handle_type[]> m_handles;
   std::size_t m_max_threads;
+  /** Storage for temporary thread handles during cleanup, which runs exclusively. */
+  std::unique_ptr<handle_type*[]> m_peer_scratch;
+  /** Handle registration state, the fields below are guarded by its mutex. */
+  std::shared_ptr<handle_registry_t> m_registry;
+  /** Flags for each handle, whether it is currently claimed. */
+  std::unique_ptr<bool[]> m_claimed;
+  /** An arbitrary registered handle in the helping ring, nullptr if there is none. */
+  handle_type* m_ring_anchor{ nullptr };
+  /** Whether handles are registered explicitly, instead of all handles being in use. */
+  bool m_registration{ false };
+  /** The maximum number of elements accepted by `try_enqueue`. */
+  std::size_t m_capacity{ UNBOUNDED };
+  /** The background thread keeping the node pool filled, if started. */
+  std::jthread m_preparer{};
+  /** Cleanup statistics of the background reclaimer, which has no thread handle. */
+  std::atomic_uint64_t m_reclaimer_cleanups{ 0 };
+  std::atomic_uint64_t m_reclaimer_freed{ 0 };
+  /** The background thread running cleanup, if required by the reclamation policy. */
+  std::jthread m_reclaimer{};
 
 public:
   /** constructor & destructor */
-  explicit erased_queue_t(std::size_t max_threads = 128);
+  explicit erased_queue_t(std::size_t max_threads = MAX_THREADS);
+  /**
+   * Constructs a queue whose node pool retains at most `pool_high_watermark` nodes and, with
+   * `huge_pages` memory, binds all node memory to `numa_node`, if given.
+   */
+  erased_queue_t(
+      std::size_t max_threads,
+      std::size_t pool_high_watermark,
+      node_memory_t memory = node_memory_t::heap,
+      std::optional<unsigned> numa_node = std::nullopt
+  );
+  /**
+   * Constructs a bounded queue, whose node pool is filled with enough nodes for `capacity`
+   * elements, so that nodes are recycled rather than allocated while `try_enqueue` is used.
+   *
+   * The reserved nodes also limit the queue's memory: spare nodes and prelinked nodes are only
+   * acquired within the reservation and `try_enqueue` fails once it is used up. Nodes are only
+   * allocated beyond it for operations that cannot complete without one, e.g. by `enqueue`, which
+   * ignores the capacity, or when a stalled thread keeps nodes from being reclaimed.
+   */
+  erased_queue_t(
+      std::size_t max_threads,
+      capacity_t capacity,
+      node_memory_t memory = node_memory_t::heap
+  );
   ~erased_queue_t() noexcept;
   /** Enqueues an element at the queue's back. */
   void enqueue(void* elem, std::size_t thread_id);
+  /**
+   * Enqueues an element at the queue's back, unless the queue holds `capacity` or more elements
+   * already or all of a bounded queue's reserved nodes are in use, concurrent calls may exceed the
+   * capacity by one element per thread.
+   */
+  bool try_enqueue(void* elem, std::size_t thread_id);
+  /** Returns the queue's capacity, `SIZE_MAX` if the queue is unbounded. */
+  std::size_t capacity() const noexcept;
+  /**
+   * Enqueues `count` elements in order at the queue's back, reserving cells for the entire batch
+   * with a single increment of the enqueue index.
+   */
+  void enqueue_bulk(void* const* elems, std::size_t count, std::size_t thread_id);
   /** Dequeues an element from the queue's front. */
   void* dequeue(std::size_t thread_id);
+  /**
+   * Dequeues an element from the queue's front, but returns nullptr without claiming a cell if
+   * the queue appears empty, so polling an empty queue neither advances its indices nor
+   * allocates nodes.
+   */
+  void* try_dequeue(std::size_t thread_id);
+  /** Returns the approximate number of elements in the queue. */
+  std::size_t size_approx() const noexcept;
+  /** Returns true if the queue appears empty. */
+  bool empty() const noexcept;
+  /**
+   * Dequeues an element from the queue's front, waiting until one becomes available.
+   *
+   * Returns nullptr only once the queue has been closed and is drained.
+   */
+  void* dequeue_wait(std::size_t thread_id);
+  /**
+   * Dequeues an element from the queue's front, waiting at most `timeout` for one to become
+   * available, returns nullptr on timeout or once the queue has been closed and is drained.
+   */
+  void* try_dequeue_for(std::chrono::nanoseconds timeout, std::size_t thread_id);
+  /**
+   * Closes the queue and wakes all waiting consumers, which return nullptr once the queue is
+   * drained. No elements must be enqueued after closing.
+   */
+  void close() noexcept;
+  /** Returns true if the queue has been closed. */
+  bool is_closed() const noexcept;
+  /**
+   * Registers the calling thread as about to park in a select over several queues and returns
+   * the current value of the wake-up word, enqueues wake up all such threads instead of one, since
+   * a select may take its element from another queue.
+   */
+  std::uint32_t announce_select() noexcept;
+  /** Deregisters a thread registered by `announce_select`. */
+  void retract_select() noexcept;
+  /** Returns the futex word, which is incremented whenever parked consumers are woken up. */
+  std::atomic_uint32_t& wake_word() noexcept;
+  /**
+   * Dequeues up to `max` elements in FIFO order from the queue's front into `out`, reserving
+   * cells for the entire batch with a single increment of the dequeue index, and returns the
+   * number of dequeued elements.
+   *
+   * Returns 0 without claiming any cells if the queue appears empty and claims no more cells than
+   * elements appear to be in the queue.
+   */
+  std::size_t dequeue_bulk(void** out, std::size_t max, std::size_t thread_id);
+  /**
+   * Claims an unused thread handle and returns its id or throws, if all handles are claimed.
+   *
+   * Once the first handle has been claimed, only claimed handles take part in helping and thread
+   * ids must no longer be used without being claimed first.
+   */
+  std::size_t acquire_handle();
+  /** Releases the claimed thread handle with the given id. */
+  void release_handle(std::size_t thread_id);
+  /** Returns the id of a handle claimed for the calling thread, claiming one on first use. */
+  std::size_t thread_local_handle();
+  /** Returns the queue's handle registry, which is shared with all tokens referencing it. */
+  const std::shared_ptr<handle_registry_t>& registry() const noexcept;
+  /** Returns the statistics of the queue's node pool. */
+  node_pool_stats_t pool_stats() const noexcept;
+  /** Frees all nodes currently held by the node pool and returns their number. */
+  std::size_t trim_pool() noexcept;
+  /**
+   * Returns the approximate number of bytes of memory held by the queue, including its thread
+   * handles and all nodes, whether linked into the queue, held as spares or retained by the pool.
+   */
+  std::size_t memory_footprint() const noexcept;
+  /**
+   * Returns a snapshot of the operation counters aggregated over all thread handles, which is
+   * only approximate while operations are in progress.
+   */
+  queue_stats_t stats() const noexcept;
+  /** Returns snapshots of the latency histograms merged over all thread handles. */
+  queue_latencies_t latencies() const;
+  /**
+   * Starts a background thread, which keeps at least `reserve` prepared (zeroed) nodes in the node
+   * pool (up to its high watermark), replacing any previously started one.
+   */
+  void start_node_preparer(std::size_t reserve);
+  /** Stops the background node preparer, if it is running. */
+  void stop_node_preparer() noexcept;
 
   erased_queue_t(const erased_queue_t&)                  = delete;
   erased_queue_t(erased_queue_t&&)                       = delete;
   const erased_queue_t& operator=(const erased_queue_t&) = delete;
   const erased_queue_t& operator=(erased_queue_t&&)      = delete;
 };
+
+/********** constructor & destructor **************************************************************/
+
+template <typename Config>
+erased_queue_t<Config>::erased_queue_t(std::size_t max_threads):
+  erased_queue_t(max_threads, max_threads * 2)
+{}
+
+template <typename Config>
+erased_queue_t<Config>::erased_queue_t(
+    std::size_t max_threads,
+    std::size_t pool_high_watermark,
+    node_memory_t memory,
+    std::optional<unsigned> numa_node
+):
+  m_node_pool{ pool_high_watermark, memory, numa_node },
+  m_handles{ std::make_unique<handle_type[]>(max_threads) },
+  m_max_threads{ max_threads },
+  m_peer_scratch{ std::make_unique<handle_type*[]>(max_threads) },
+  m_registry{ std::make_shared<handle_registry_t>() },
+  m_claimed{ std::make_unique<bool[]>(max_threads) }
+{
+  if (max_threads == 0 || max_threads > MAX_THREADS) {
+    throw std::invalid_argument("max_threads must be between 1 and MaxThreads");
+  }
+
+  this->m_registry->queue = this;
+  this->m_registry->acquire_locked = [](void* queue) {
+    return static_cast<erased_queue_t*>(queue)->acquire_handle_locked();
+  };
+  this->m_registry->release_locked = [](void* queue, std::size_t thread_id) {
+    static_cast<erased_queue_t*>(queue)->release_handle_locked(thread_id);
+  };
+
+  // install empty head node
+  auto node = this->m_node_pool.allocate();
+  this->m_head.store(node, relaxed);
+  this->m_directory.publish(node);
+
+  for (std::size_t i = 0; i < max_threads; ++i) {
+    auto& handle = this->m_handles[i];
+    auto next = i == max_threads - 1
+        ? &this->m_handles[0]
+        : &this->m_handles[i + 1];
+
+    // spare nodes are only acquired once a handle is used, see `refill_spare`
+    handle.tail.store(node, relaxed);
+    handle.head.store(node, relaxed);
+    handle.backoff = backoff_type::INITIAL;
+    handle.next = next;
+    handle.help_next.store(next, relaxed);
+    handle.enq_help_handle = next;
+    handle.deq_help_handle = next;
+  }
+
+  if constexpr (reclaim_type::BACKGROUND) {
+    this->m_reclaimer = std::jthread([this](std::stop_token stop) {
+      constexpr std::chrono::microseconds max_interval =
+          reclaim_type::INTERVAL * reclaim_type::IDLE_FACTOR;
+      std::mutex mutex{};
+      std::condition_variable_any stopped{};
+      auto interval = reclaim_type::INTERVAL;
+
+      while (!stop.stop_requested()) {
+        // back off while there is nothing to reclaim, e.g. because the queue is idle
+        interval = this->background_cleanup() != 0
+            ? reclaim_type::INTERVAL
+            : std::min(interval * 2, max_interval);
+
+        std::unique_lock lock{ mutex };
+        stopped.wait_for(lock, stop, interval, [] { return false; });
+      }
+    });
+  }
+}
+
+template <typename Config>
+erased_queue_t<Config>::erased_queue_t(
+    std::size_t max_threads,
+    capacity_t capacity,
+    node_memory_t memory
+):
+  // nodes for all elements, a partially filled node at either end, the nodes which may trail
+  // behind the head until the reclamation policy frees them and one spare node per handle
+  erased_queue_t(
+      max_threads,
+      (capacity.elements + NODE_SIZE - 1) / NODE_SIZE + 2
+          + static_cast<std::size_t>(reclaim_type::retained(max_threads)) + max_threads,
+      memory
+  )
+{
+  if (capacity.elements == 0) {
+    throw std::invalid_argument("capacity must be at least 1");
+  }
+
+  this->m_capacity = capacity.elements;
+  // the reserved nodes and the initial head node are all the queue acquires within its limit
+  const auto reserved = this->m_node_pool.reserve(this->m_node_pool.stats().high_watermark);
+  this->m_node_pool.limit(reserved + 1);
+}
+
+template <typename Config>
+erased_queue_t<Config>::~erased_queue_t() noexcept {
+  this->stop_node_preparer();
+  if (this->m_reclaimer.joinable()) {
+    this->m_reclaimer.request_stop();
+    this->m_reclaimer.join();
+  }
+  // detach any remaining thread-local registrations and tokens, which may outlive the queue
+  this->m_registry->detach();
+
+  // delete all remaining nodes in the queue, including retired ones, which precede the head
+  auto curr = this->m_retired != nullptr ? this->m_retired : this->m_head.load(relaxed);
+  while (curr != nullptr) {
+    auto tmp = curr;
+    curr = curr->next.load(relaxed);
+    this->m_node_pool.deallocate(tmp);
+  }
+
+  // delete any remaining thread-local spare nodes
+  for (std::size_t i = 0; i < this->m_max_threads; ++i) {
+    if (auto spare = this->m_handles[i].spare_node; spare != nullptr) {
+      this->m_node_pool.deallocate(spare);
+    }
+#if YMC_QUEUE_LATENCY
+    delete this->m_handles[i].latencies.load(relaxed);
+#endif
+  }
+}
+
+/********** public methods ************************************************************************/
+
+template <typename Config>
+void erased_queue_t<Config>::enqueue(void* elem, std::size_t thread_id) {
+  auto& th = this->m_handles[thread_id];
+  const auto start = LATENCY ? this->start_timing(th) : 0;
+  this->protect(th, th.tail_node_id);
+
+  const auto fast = this->enq(elem, th);
+
+  th.tail_node_id = th.tail.load(relaxed)->id;
+  this->unprotect(th);
+
+  this->wake_waiters();
+
+  if constexpr (LATENCY) {
+    auto& latencies = *th.latencies.load(relaxed);
+    auto& recorder = fast ? latencies.fast_enqueue : latencies.slow_enqueue;
+    recorder.record(read_tsc() - start);
+  }
+}
+
+template <typename Config>
+bool erased_queue_t<Config>::try_enqueue(void* elem, std::size_t thread_id) {
+  if (this->m_capacity != UNBOUNDED) {
+    const auto deq_idx = this->m_deq_idx.load(relaxed);
+    const auto enq_idx = this->m_enq_idx.load(relaxed);
+    if (enq_idx - deq_idx >= static_cast<std::intmax_t>(this->m_capacity)) {
+      return false;
+    }
+
+    // without a spare node, the enqueue might have to allocate a node beyond the reservation
+    if (
+        this->m_handles[thread_id].spare_node == nullptr
+        && this->m_node_pool.exhausted()
+    ) {
+      return false;
+    }
+  }
+
+  this->enqueue(elem, thread_id);
+  return true;
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::capacity() const noexcept {
+  return this->m_capacity;
+}
+
+template <typename Config>
+void erased_queue_t<Config>::enqueue_bulk(
+    void* const* elems,
+    std::size_t count,
+    std::size_t thread_id
+) {
+  if (count == 0) {
+    return;
+  }
+
+  auto& th = this->m_handles[thread_id];
+  this->protect(th, th.tail_node_id);
+
+  // reserve a contiguous range of cells for the entire batch at once
+  const auto first = this->m_enq_idx.fetch_add(static_cast<std::intmax_t>(count), seq_cst);
+
+  std::size_t n = 0;
+  for (; n < count; ++n) {
+    // the cached tail node always precedes the cell, so nodes are walked only once
+    auto [cell, curr] = find_cell(th.tail, th, this->m_node_pool, this->m_directory, first + n);
+    th.tail.store(&curr, relaxed);
+    this->prelink(first + n, curr, th);
+
+    void* expected = nullptr;
+    if (!cell.val.compare_exchange_strong(expected, elems[n], relaxed, relaxed)) {
+      break;
+    }
+  }
+
+  th.counters.add(counter_t::fast_enqueues, n);
+
+  // the cell was already poisoned by a dequeuer, so the remaining reserved cells are abandoned
+  // and the rest of the batch is enqueued one by one to preserve its order
+  for (; n < count; ++n) {
+    this->enq(elems[n], th);
+  }
+
+  th.tail_node_id = th.tail.load(relaxed)->id;
+  this->unprotect(th);
+
+  this->wake_waiters();
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::dequeue(std::size_t thread_id) {
+  // a bounded queue must not consume cells (and eventually nodes) while it is empty
+  if (this->m_capacity != UNBOUNDED && this->maybe_empty()) {
+    return nullptr;
+  }
+
+  auto& th = this->m_handles[thread_id];
+  const auto start = LATENCY ? this->start_timing(th) : 0;
+  this->protect(th, th.head_node_id);
+
+  bool fast = true;
+  auto res = this->deq(th, fast);
+
+  // with a single consumer, no peer can have a pending dequeue request
+  if (!SINGLE_CONSUMER && res != nullptr) {
+    this->help_deq(th, *th.deq_help_handle);
+    th.deq_help_handle = th.deq_help_handle->help_next.load(relaxed);
+  }
+
+  th.head_node_id = th.head.load(relaxed)->id;
+  this->unprotect(th);
+
+  this->replenish(th);
+
+  if constexpr (LATENCY) {
+    auto& latencies = *th.latencies.load(relaxed);
+    auto& recorder = fast ? latencies.fast_dequeue : latencies.slow_dequeue;
+    recorder.record(read_tsc() - start);
+  }
+
+  return res;
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::try_dequeue(std::size_t thread_id) {
+  if (this->maybe_empty()) {
+    return nullptr;
+  }
+
+  return this->dequeue(thread_id);
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::size_approx() const noexcept {
+  const auto deq_idx = this->m_deq_idx.load(relaxed);
+  const auto enq_idx = this->m_enq_idx.load(relaxed);
+  return enq_idx > deq_idx ? static_cast<std::size_t>(enq_idx - deq_idx) : 0;
+}
+
+template <typename Config>
+bool erased_queue_t<Config>::empty() const noexcept {
+  return this->maybe_empty();
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::dequeue_wait(std::size_t thread_id) {
+  return this->dequeue_until(thread_id, std::nullopt);
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::try_dequeue_for(
+    std::chrono::nanoseconds timeout,
+    std::size_t thread_id
+) {
+  return this->dequeue_until(thread_id, std::chrono::steady_clock::now() + timeout);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::close() noexcept {
+  this->m_closed.store(true, seq_cst);
+  this->m_wake_seq.fetch_add(1, release);
+  unpark(this->m_wake_seq, std::numeric_limits<int>::max());
+}
+
+template <typename Config>
+bool erased_queue_t<Config>::is_closed() const noexcept {
+  return this->m_closed.load(acquire);
+}
+
+template <typename Config>
+std::uint32_t erased_queue_t<Config>::announce_select() noexcept {
+  this->m_waiters.fetch_add(SELECT_WAITER, seq_cst);
+  return this->m_wake_seq.load(seq_cst);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::retract_select() noexcept {
+  this->m_waiters.fetch_sub(SELECT_WAITER, relaxed);
+}
+
+template <typename Config>
+std::atomic_uint32_t& erased_queue_t<Config>::wake_word() noexcept {
+  return this->m_wake_seq;
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::dequeue_bulk(
+    void** out,
+    std::size_t max,
+    std::size_t thread_id
+) {
+  // claiming cells of an empty queue would poison them and force enqueuers onto the slow path
+  if (max == 0 || this->maybe_empty()) {
+    return 0;
+  }
+
+  auto& th = this->m_handles[thread_id];
+  this->protect(th, th.head_node_id);
+
+  // reserve a contiguous range of cells for the entire batch at once, but no more cells than
+  // elements were observed in the queue
+  const auto batch = std::max<std::size_t>(1, std::min(max, this->size_approx()));
+  const auto first = this->claim_deq_idx(static_cast<std::intmax_t>(batch));
+
+  std::size_t count = 0;
+  bool empty = false;
+
+  // every reserved cell must be resolved, so that no element can be enqueued into a cell which
+  // is never visited by any dequeuer
+  for (std::size_t n = 0; n < batch; ++n) {
+    const auto i = first + static_cast<std::intmax_t>(n);
+    auto [cell, curr] = find_cell(th.head, th, this->m_node_pool, this->m_directory, i);
+    th.head.store(&curr, relaxed);
+
+    auto res = this->help_enq(cell, th, i);
+    if (res == nullptr) {
+      empty = true;
+      continue;
+    }
+
+    if (res != top_ptr<void>() && this->claim_cell(cell)) {
+      out[count++] = res;
+    }
+  }
+
+  // all reserved cells were lost to racing enqueuers or slow dequeuers without the queue ever
+  // being observed as empty, so fall back to the regular protocol for a single element
+  if (count == 0 && !empty) {
+    bool fast = true;
+    if (auto res = this->deq(th, fast); res != nullptr) {
+      out[count++] = res;
+    }
+  }
+
+  th.counters.add(counter_t::fast_dequeues, count);
+
+  // helping is amortized over the entire batch
+  if (!SINGLE_CONSUMER && count != 0) {
+    this->help_deq(th, *th.deq_help_handle);
+    th.deq_help_handle = th.deq_help_handle->help_next.load(relaxed);
+  }
+
+  th.head_node_id = th.head.load(relaxed)->id;
+  this->unprotect(th);
+
+  this->replenish(th);
+
+  return count;
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::acquire_handle() {
+  return this->m_registry->acquire();
+}
+
+template <typename Config>
+void erased_queue_t<Config>::release_handle(std::size_t thread_id) {
+  this->m_registry->release(thread_id);
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::thread_local_handle() {
+  return detail::thread_local_handle(this->m_registry);
+}
+
+template <typename Config>
+const std::shared_ptr<handle_registry_t>& erased_queue_t<Config>::registry() const noexcept {
+  return this->m_registry;
+}
+
+template <typename Config>
+node_pool_stats_t erased_queue_t<Config>::pool_stats() const noexcept {
+  return this->m_node_pool.stats();
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::trim_pool() noexcept {
+  return this->m_node_pool.trim();
+}
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::memory_footprint() const noexcept {
+  const auto per_thread = sizeof(handle_type) + sizeof(handle_type*) + sizeof(bool);
+  auto res = sizeof(*this) + this->m_max_threads * per_thread;
+#if YMC_QUEUE_LATENCY
+  for (std::size_t i = 0; i < this->m_max_threads; ++i) {
+    if (this->m_handles[i].latencies.load(relaxed) != nullptr) {
+      res += sizeof(handle_latencies_t);
+    }
+  }
+#endif
+
+  return res + this->m_node_pool.memory_footprint();
+}
+
+template <typename Config>
+queue_stats_t erased_queue_t<Config>::stats() const noexcept {
+  queue_stats_t res{};
+  std::uint64_t spares = 0;
+
+  for (std::size_t i = 0; i < this->m_max_threads; ++i) {
+    const auto& counters = this->m_handles[i].counters;
+    res.fast_enqueues += counters.get(counter_t::fast_enqueues);
+    res.slow_enqueues += counters.get(counter_t::slow_enqueues);
+    res.fast_dequeues += counters.get(counter_t::fast_dequeues);
+    res.slow_dequeues += counters.get(counter_t::slow_dequeues);
+    res.helps += counters.get(counter_t::helps);
+    res.cells_burned += counters.get(counter_t::cells_burned);
+    res.nodes_allocated += counters.get(counter_t::nodes_allocated);
+    res.nodes_freed += counters.get(counter_t::nodes_freed);
+    res.cleanup_attempts += counters.get(counter_t::cleanup_attempts);
+    res.cleanup_successes += counters.get(counter_t::cleanup_successes);
+    spares += counters.get(counter_t::spare_nodes);
+  }
+
+  if (res.enabled) {
+    const auto cleanups = this->m_reclaimer_cleanups.load(relaxed);
+    res.cleanup_attempts += cleanups;
+    res.cleanup_successes += cleanups;
+    res.nodes_freed += this->m_reclaimer_freed.load(relaxed);
+
+    // only the head node is allocated on construction, spare nodes are counted when acquired
+    const auto live = 1 + res.nodes_allocated - res.nodes_freed;
+    res.node_bytes = (live - std::min(spares, live)) * sizeof(node_type);
+    res.spare_bytes = spares * sizeof(node_type);
+  }
+
+  return res;
+}
+
+template <typename Config>
+queue_latencies_t erased_queue_t<Config>::latencies() const {
+  queue_latencies_t res{};
+  if constexpr (LATENCY) {
+    for (std::size_t i = 0; i < this->m_max_threads; ++i) {
+      const auto handle_latencies = this->m_handles[i].latencies.load(acquire);
+      if (handle_latencies == nullptr) {
+        continue;
+      }
+
+      const auto& latencies = *handle_latencies;
+      latencies.fast_enqueue.merge_into(res.fast_enqueue);
+      latencies.slow_enqueue.merge_into(res.slow_enqueue);
+      latencies.fast_dequeue.merge_into(res.fast_dequeue);
+      latencies.slow_dequeue.merge_into(res.slow_dequeue);
+    }
+  }
+
+  return res;
+}
+
+template <typename Config>
+void erased_queue_t<Config>::start_node_preparer(std::size_t reserve) {
+  this->stop_node_preparer();
+  this->m_preparer = std::jthread([this, reserve](std::stop_token stop) {
+    while (!stop.stop_requested()) {
+      this->m_node_pool.reserve(reserve);
+      std::this_thread::sleep_for(PREPARER_INTERVAL);
+    }
+  });
+}
+
+template <typename Config>
+void erased_queue_t<Config>::stop_node_preparer() noexcept {
+  if (this->m_preparer.joinable()) {
+    this->m_preparer.request_stop();
+    this->m_preparer.join();
+  }
+}
+
+/********** private methods ***********************************************************************/
+
+template <typename Config>
+std::size_t erased_queue_t<Config>::acquire_handle_locked() {
+  if (!this->m_registration) {
+    // switch to explicit registration, all handles leave the helping ring
+    this->m_registration = true;
+    this->m_ring_anchor = nullptr;
+  }
+
+  const auto end = this->m_claimed.get() + this->m_max_threads;
+  const auto it = std::find(this->m_claimed.get(), end, false);
+  if (it == end) {
+    throw std::runtime_error("all thread handles are claimed");
+  }
+
+  *it = true;
+  const auto id = static_cast<std::size_t>(it - this->m_claimed.get());
+  this->ring_insert(this->m_handles[id]);
+
+  return id;
+}
+
+template <typename Config>
+void erased_queue_t<Config>::release_handle_locked(std::size_t thread_id) {
+  if (!this->m_claimed[thread_id]) {
+    return;
+  }
+
+  this->m_claimed[thread_id] = false;
+  this->ring_remove(this->m_handles[thread_id]);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::ring_insert(handle_type& th) {
+  if (this->m_ring_anchor == nullptr) {
+    th.help_next.store(&th, release);
+    this->m_ring_anchor = &th;
+  } else {
+    th.help_next.store(this->m_ring_anchor->help_next.load(relaxed), relaxed);
+    this->m_ring_anchor->help_next.store(&th, release);
+  }
+
+  // start helping at the handle's successor
+  th.Ei = 0;
+  th.enq_help_handle = th.help_next.load(relaxed);
+  th.deq_help_handle = th.help_next.load(relaxed);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::ring_remove(handle_type& th) {
+  const auto next = th.help_next.load(relaxed);
+  if (next == &th) {
+    this->m_ring_anchor = nullptr;
+    return;
+  }
+
+  auto pred = next;
+  while (pred->help_next.load(relaxed) != &th) {
+    pred = pred->help_next.load(relaxed);
+  }
+
+  // the removed handle keeps pointing into the ring, so peers currently visiting it proceed to
+  // registered handles
+  pred->help_next.store(next, release);
+  if (this->m_ring_anchor == &th) {
+    this->m_ring_anchor = pred;
+  }
+}
+
+template <typename Config>
+std::uint64_t erased_queue_t<Config>::start_timing(handle_type& th) {
+#if YMC_QUEUE_LATENCY
+  // like spare nodes, histograms are only allocated for handles in use, before the operation
+  // starts, so a failed allocation leaves the queue unchanged
+  if (th.latencies.load(relaxed) == nullptr) [[unlikely]] {
+    th.latencies.store(new handle_latencies_t(), release);
+  }
+#endif
+
+  return read_tsc();
+}
+
+template <typename Config>
+void erased_queue_t<Config>::protect(handle_type& th, std::uintmax_t node_id) noexcept {
+  if constexpr (reclaim_type::EPOCH) {
+    // the announcement must be visible to cleanup before any node pointer is loaded
+    th.epoch.store(this->m_epoch.load(relaxed), seq_cst);
+  } else {
+    th.hzd_node_id.store(node_id, relaxed);
+  }
+}
+
+template <typename Config>
+void erased_queue_t<Config>::unprotect(handle_type& th) noexcept {
+  if constexpr (reclaim_type::EPOCH) {
+    th.epoch.store(NO_EPOCH, release);
+  } else {
+    th.hzd_node_id.store(NO_HAZARD, release);
+  }
+}
+
+template <typename Config>
+void erased_queue_t<Config>::cleanup(handle_type& th) {
+  th.counters.add(counter_t::cleanup_attempts);
+  auto oid = this->m_help_idx.load(acquire);
+
+  if (oid == -1) {
+    return;
+  }
+
+  // the handle's hazard is already cleared, so its head node may be freed by a concurrent
+  // cleanup and must not be dereferenced before the lock is held, its cached id is used instead
+  const auto head_id = static_cast<std::intmax_t>(th.head_node_id);
+  if (head_id - oid < reclaim_type::threshold(this->m_max_threads)) {
+    return;
+  }
+
+  if (
+      !this->m_help_idx.compare_exchange_strong(oid, -1, acquire, relaxed)
+  ) {
+    return;
+  }
+
+  // from here on only one thread, which also keeps the head node from being freed
+  auto new_node = th.head.load(relaxed);
+  if (const auto freed = this->reclaim_locked(oid, new_node, th); freed != 0) {
+    th.counters.add(counter_t::cleanup_successes);
+    th.counters.add(counter_t::nodes_freed, freed);
+  }
+}
+
+template <typename Config>
+std::uint64_t erased_queue_t<Config>::reclaim_locked(
+    std::intmax_t oid,
+    node_type* new_node,
+    handle_type& first
+) {
+  auto lDi = this->m_deq_idx.load(relaxed);
+  auto lEi = this->m_enq_idx.load(relaxed);
+
+  // enqueuers must not claim cells dequeuers have already passed, which may be in nodes about to
+  // be freed, but equal indices are the regular state of an empty queue, advancing the enqueue
+  // index beyond would leave a cell that is never filled but counts against a bounded capacity
+  while (
+      lEi < lDi
+      && !this->m_enq_idx.compare_exchange_weak(
+          lEi, lDi, relaxed, relaxed)
+  ) {}
+
+  if constexpr (reclaim_type::EPOCH) {
+    return this->retire_locked(oid, new_node, first);
+  }
+
+  auto old_node = this->m_head.load(relaxed);
+  auto ph = &first;
+  auto i = 0;
+
+  do {
+    new_node = check(ph->hzd_node_id, new_node, old_node, this->m_directory);
+    new_node = update(ph->tail, ph->hzd_node_id, new_node, old_node, this->m_directory);
+    new_node = update(ph->head, ph->hzd_node_id, new_node, old_node, this->m_directory);
+
+    this->m_peer_scratch[i++] = ph;
+    ph = ph->next;
+  } while (new_node->id > oid && ph != &first);
+
+  while (new_node->id > oid && --i >= 0) {
+    new_node = check(
+        this->m_peer_scratch[i]->hzd_node_id, new_node, old_node, this->m_directory);
+  }
+
+  const auto nid = new_node->id;
+
+  if (nid <= oid) {
+    this->m_help_idx.store(oid, release);
+    return 0;
+  }
+
+  this->m_head.store(new_node, relaxed);
+  this->m_help_idx.store(nid, release);
+
+  std::uint64_t freed = 0;
+  while (old_node != new_node) {
+    auto tmp = old_node->next.load(relaxed);
+    this->m_node_pool.release(old_node);
+    old_node = tmp;
+    freed += 1;
+  }
+
+  return freed;
+}
+
+template <typename Config>
+std::uint64_t erased_queue_t<Config>::retire_locked(
+    std::intmax_t oid,
+    node_type* new_node,
+    handle_type& first
+) {
+  auto old_node = this->m_head.load(relaxed);
+  auto ph = &first;
+
+  // handles in an operation keep the nodes from their head and tail onwards, whereas idle handles
+  // are advanced, since they cannot start an operation from a node older than their epoch
+  do {
+    const auto idle = ph->epoch.load(seq_cst) == NO_EPOCH;
+    for (auto peer_node : { &ph->tail, &ph->head }) {
+      auto node = peer_node->load(acquire);
+      if (node->id >= new_node->id) {
+        continue;
+      }
+
+      if (idle && peer_node->compare_exchange_strong(node, new_node, seq_cst, seq_cst)) {
+        continue;
+      }
+
+      // the peer is in an operation or has just advanced its pointer itself
+      if (node->id < new_node->id) {
+        new_node = node;
+      }
+    }
+
+    ph = ph->next;
+  } while (new_node->id > oid && ph != &first);
+
+  auto nid = oid;
+  if (new_node->id > oid) {
+    nid = new_node->id;
+    this->m_head.store(new_node, relaxed);
+    if (this->m_retired == nullptr) {
+      this->m_retired = old_node;
+    }
+
+    // the nodes are unlinked from all handles before the epoch of their retirement is read
+    const auto epoch = this->m_epoch.load(seq_cst);
+    const auto count = this->m_retired_count;
+    if (count != 0 && this->m_retired_ranges[count - 1].first == epoch) {
+      this->m_retired_ranges[count - 1].second = new_node;
+    } else {
+      this->m_retired_ranges[this->m_retired_count++] = { epoch, new_node };
+    }
+  }
+
+  // the epoch advances once all handles in an operation have announced the current one
+  auto epoch = this->m_epoch.load(relaxed);
+  auto quiescent = true;
+  for (std::size_t i = 0; i < this->m_max_threads && quiescent; ++i) {
+    const auto announced = this->m_handles[i].epoch.load(seq_cst);
+    quiescent = announced == NO_EPOCH || announced == epoch;
+  }
+
+  if (quiescent) {
+    epoch += 1;
+    this->m_epoch.store(epoch, seq_cst);
+  }
+
+  // nodes retired two epochs ago can no longer be reached by any operation
+  std::uint64_t freed = 0;
+  while (this->m_retired_count != 0 && this->m_retired_ranges[0].first + 2 <= epoch) {
+    const auto end = this->m_retired_ranges[0].second;
+    while (this->m_retired != end) {
+      auto tmp = this->m_retired->next.load(relaxed);
+      this->m_node_pool.release(this->m_retired);
+      this->m_retired = tmp;
+      freed += 1;
+    }
+
+    this->m_retired_ranges[0] = this->m_retired_ranges[1];
+    this->m_retired_count -= 1;
+  }
+
+  if (this->m_retired_count == 0) {
+    this->m_retired = nullptr;
+  }
+
+  this->m_help_idx.store(nid, release);
+  return freed;
+}
+
+template <typename Config>
+std::uint64_t erased_queue_t<Config>::background_cleanup() {
+  auto oid = this->m_help_idx.load(acquire);
+  if (oid == -1) {
+    return 0;
+  }
+
+  // no dequeuer can claim a cell in a node before the one of the current dequeue index
+  const auto target = node_type::node_id_of(this->m_deq_idx.load(relaxed));
+  if (target - oid < reclaim_type::threshold(this->m_max_threads)) {
+    return 0;
+  }
+
+  if (!this->m_help_idx.compare_exchange_strong(oid, -1, acquire, relaxed)) {
+    return 0;
+  }
+
+  // nodes from the head onwards can only be freed by this thread, so the list can be walked
+  auto new_node = this->m_directory.find(target);
+  if (new_node == nullptr) {
+    new_node = this->m_head.load(relaxed);
+  }
+
+  while (new_node->id < target) {
+    auto next = new_node->next.load(acquire);
+    if (next == nullptr) {
+      break;
+    }
+
+    new_node = next;
+  }
+
+  const auto freed = this->reclaim_locked(oid, new_node, this->m_handles[0]);
+  if (freed != 0) {
+    this->m_reclaimer_cleanups.fetch_add(1, relaxed);
+    this->m_reclaimer_freed.fetch_add(freed, relaxed);
+  }
+
+  return freed;
+}
+
+template <typename Config>
+void erased_queue_t<Config>::replenish(handle_type& th) {
+  // a bounded queue's nodes come from a fixed reservation, so it attempts cleanup after every
+  // dequeue instead of only once the handle has used up its spare node
+  if (th.spare_node != nullptr && this->m_capacity == UNBOUNDED) {
+    return;
+  }
+
+  if constexpr (!reclaim_type::BACKGROUND) {
+    this->cleanup(th);
+  }
+
+  if (th.spare_node == nullptr) {
+    this->refill_spare(th);
+  }
+}
+
+template <typename Config>
+void erased_queue_t<Config>::refill_spare(handle_type& th) {
+  // at a bounded queue's limit, spare nodes are only acquired once needed, see `link_next`
+  th.spare_node = this->m_node_pool.try_acquire();
+  if (th.spare_node == nullptr) {
+    return;
+  }
+
+  th.counters.add(counter_t::nodes_allocated);
+  th.counters.set(counter_t::spare_nodes, 1);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::prelink(std::intmax_t idx, node_type& curr, handle_type& th) {
+  // prelinking is only an optimization, so it must not allocate beyond a bounded queue's limit
+  if (
+      node_type::cell_of(idx) == PRELINK_CELL
+      && (th.spare_node != nullptr || !this->m_node_pool.exhausted())
+  ) {
+    link_next(curr, th, this->m_node_pool, this->m_directory);
+  }
+}
+
+/********** private methods (blocking dequeue) ****************************************************/
+
+template <typename Config>
+bool erased_queue_t<Config>::maybe_empty() const noexcept {
+  // a dequeue claiming an index at or beyond the enqueue index can only find an empty cell
+  return this->m_deq_idx.load(seq_cst) >= this->m_enq_idx.load(seq_cst);
+}
+
+template <typename Config>
+void erased_queue_t<Config>::wake_waiters() noexcept {
+  // the enqueue's last seq_cst operation on the enqueue index (or the fence in enq_slow) orders
+  // this load after the element's index became visible, a parking consumer either observes that
+  // index or is observed here
+  if (const auto waiters = this->m_waiters.load(seq_cst); waiters != 0) {
+    this->m_wake_seq.fetch_add(1, release);
+    unpark(this->m_wake_seq, waiters >= SELECT_WAITER ? std::numeric_limits<int>::max() : 1);
+  }
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::dequeue_until(
+    std::size_t thread_id,
+    std::optional<std::chrono::steady_clock::time_point> deadline
+) {
+  while (true) {
+    // spin briefly, without claiming cells while the queue appears empty
+    for (std::size_t spin = 0; spin < SPIN_LIMIT; ++spin) {
+      const auto closed = this->m_closed.load(acquire);
+      if (!this->maybe_empty() || closed) {
+        if (auto res = this->dequeue(thread_id); res != nullptr || closed) {
+          return res;
+        }
+      }
+
+      cpu_relax();
+    }
+
+    if (deadline.has_value() && std::chrono::steady_clock::now() >= *deadline) {
+      return nullptr;
+    }
+
+    // announce the intent to park before checking for emptiness one final time
+    this->m_waiters.fetch_add(1, seq_cst);
+    const auto seq = this->m_wake_seq.load(seq_cst);
+    if (this->maybe_empty() && !this->m_closed.load(seq_cst)) {
+      park(this->m_wake_seq, seq, deadline);
+    }
+    this->m_waiters.fetch_sub(1, relaxed);
+  }
+}
+
+/********** private methods (enqueue) *************************************************************/
+
+template <typename Config>
+bool erased_queue_t<Config>::enq(void* elem, handle_type& th) {
+  std::intmax_t id = 0;
+  bool success = false;
+
+  for (std::size_t patience = 0; patience < PATIENCE; ++patience) {
+    success = this->enq_fast(elem, th, id);
+    backoff_type::record(th.backoff, !success);
+    if (success) {
+      break;
+    }
+
+    if (patience + 1 < PATIENCE) {
+      spin(backoff_type::spins(th.backoff));
+    }
+  }
+
+  if (success) {
+    th.counters.add(counter_t::fast_enqueues);
+  } else {
+    th.counters.add(counter_t::slow_enqueues);
+    this->enq_slow(elem, th, id);
+  }
+
+  return success;
+}
+
+template <typename Config>
+bool erased_queue_t<Config>::enq_fast(
+    void* elem,
+    handle_type& thread_handle,
+    std::intmax_t& id
+) {
+  const auto i = this->m_enq_idx.fetch_add(1, seq_cst);
+  auto [cell, curr] = find_cell(
+      thread_handle.tail, thread_handle, this->m_node_pool, this->m_directory, i);
+  thread_handle.tail.store(&curr, relaxed);
+  this->prelink(i, curr, thread_handle);
+
+  void* expected = nullptr;
+  if (cell.val.compare_exchange_strong(expected, elem, relaxed, relaxed)) {
+    return true;
+  } else {
+    id = i;
+    return false;
+  }
+}
+
+template <typename Config>
+void erased_queue_t<Config>::enq_slow(
+    void* elem,
+    handle_type& thread_handle,
+    std::intmax_t id
+) {
+  if constexpr (SINGLE_PRODUCER) {
+    if (this->m_producer.load(relaxed) != &thread_handle) {
+      this->m_producer.store(&thread_handle, release);
+    }
+  }
+
+  auto& enq = thread_handle.enq_req;
+  enq.val.store(elem, relaxed);
+  enq.id.store(id, release);
+
+  std::intmax_t i;
+  do {
+    i = this->m_enq_idx.fetch_add(1, relaxed);
+    auto [cell, _ignore] = find_cell(
+        thread_handle.tail, thread_handle, this->m_node_pool, this->m_directory, i);
+
+    enq_req_t* expected = nullptr;
+    if (
+        cell.enq_req.compare_exchange_strong(expected, &enq, seq_cst, seq_cst)
+        && cell.val.load(relaxed) != top_ptr<enq_req_t>()
+    ) {
+      if (enq.id.compare_exchange_strong(id, -i, relaxed, relaxed)) {
+        id = -i;
+      }
+
+      break;
+    }
+  } while (enq.id.load(relaxed) > 0);
+
+  id = -enq.id.load(relaxed);
+  auto [cell, curr] = find_cell(
+      thread_handle.tail, thread_handle, this->m_node_pool, this->m_directory, id);
+  thread_handle.tail.store(&curr, relaxed);
+
+  if (id > i) {
+    auto lEi = this->m_enq_idx.load(relaxed);
+    while (
+        lEi <= id
+        && !this->m_enq_idx.compare_exchange_weak(
+            lEi, id + 1, relaxed, relaxed)
+    ) {}
+  }
+
+  cell.val.store(elem, relaxed);
+  // orders the (relaxed) updates of the enqueue index before checking for waiting consumers
+  std::atomic_thread_fence(seq_cst);
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::help_enq(
+    cell_ref_t cell,
+    handle_type& thread_handle,
+    std::intmax_t node_id
+) {
+  auto res = cell.val.load(acquire);
+
+  if (res != top_ptr<void>() && res != nullptr) {
+    return res;
+  }
+
+  // give an enqueuer, which has already claimed the cell's index but not yet stored its element,
+  // a chance to do so before poisoning the cell
+  if (res == nullptr) {
+    const auto spins = backoff_type::spins(thread_handle.backoff);
+    if (spins != 0 && this->m_enq_idx.load(relaxed) > node_id) {
+      const auto filled = spin_until(spins, [&] {
+        return (res = cell.val.load(acquire)) != nullptr;
+      });
+
+      if (filled && res != top_ptr<void>()) {
+        return res;
+      }
+    }
+  }
+
+  if (res == nullptr) {
+    if (cell.val.compare_exchange_strong(res, top_ptr<void>(), seq_cst, seq_cst)) {
+      thread_handle.counters.add(counter_t::cells_burned);
+    } else if (res != top_ptr<void>()) {
+      return res;
+    }
+  }
+
+  auto enq = cell.enq_req.load(relaxed);
+
+  if (enq == nullptr && SINGLE_PRODUCER) {
+    // the only enqueue request which can be pending is that of the single producer
+    if (auto ph = this->m_producer.load(acquire); ph != nullptr) {
+      auto pe = &ph->enq_req;
+      const auto id = pe->id.load(relaxed);
+      if (id > 0 && id <= node_id) {
+        cell.enq_req.compare_exchange_strong(enq, pe, relaxed, relaxed);
+      }
+    }
+
+    if (
+        enq == nullptr && cell.enq_req.compare_exchange_strong(
+            enq, top_ptr<enq_req_t>(), relaxed, relaxed
+        )
+    ) {
+      enq = top_ptr<enq_req_t>();
+    }
+  } else if (enq == nullptr) {
+    auto ph = thread_handle.enq_help_handle;
+    auto pe = &ph->enq_req;
+    auto id = pe->id.load(relaxed);
+
+    if (thread_handle.Ei != 0 && thread_handle.Ei != id) {
+      thread_handle.Ei = 0;
+      thread_handle.enq_help_handle = ph->help_next.load(relaxed);
+      ph = thread_handle.enq_help_handle;
+      pe = &ph->enq_req;
+      id = pe->id;
+    }
+
+    if (
+        id > 0 && id <= node_id
+        && !cell.enq_req.compare_exchange_strong(enq, pe, relaxed, relaxed)
+        && enq != pe
+    ) {
+      thread_handle.Ei = id;
+    } else {
+      thread_handle.Ei = 0;
+      thread_handle.enq_help_handle = ph->help_next.load(relaxed);
+    }
+
+    if (
+        enq == nullptr && cell.enq_req.compare_exchange_strong(
+            enq, top_ptr<enq_req_t>(), relaxed, relaxed
+        )
+    ) {
+      enq = top_ptr<enq_req_t>();
+    }
+  }
+
+  if (enq == top_ptr<enq_req_t>()) {
+    return (this->m_enq_idx.load(relaxed) <= node_id ? nullptr : top_ptr<void>());
+  }
+
+  auto enq_id = enq->id.load(acquire);
+  const auto enq_val = enq->val.load(acquire);
+
+  if (enq_id > node_id) {
+    if (
+        cell.val.load(relaxed) == top_ptr<void>()
+        && this->m_enq_idx.load(relaxed) <= node_id
+    ) {
+      return nullptr;
+    }
+  } else {
+    if (
+        (enq_id > 0 && enq->id.compare_exchange_strong(enq_id, -node_id, relaxed, relaxed))
+        || (enq_id == -node_id && cell.val.load(relaxed) == top_ptr<void>())
+    ) {
+      auto lEi = this->m_enq_idx.load(relaxed);
+      while (lEi <= node_id && !this->m_enq_idx.compare_exchange_strong(lEi, node_id + 1, relaxed, relaxed)) {}
+      cell.val.store(enq_val, relaxed);
+      if (enq != &thread_handle.enq_req) {
+        thread_handle.counters.add(counter_t::helps);
+      }
+    }
+  }
+
+  return cell.val.load(relaxed);
+}
+
+/********** private methods (dequeue) *************************************************************/
+
+template <typename Config>
+std::intmax_t erased_queue_t<Config>::claim_deq_idx(std::intmax_t count) noexcept {
+  if constexpr (SINGLE_CONSUMER) {
+    // only the consumer itself advances the dequeue index, helpers of dequeue requests never run
+    const auto i = this->m_deq_idx.load(relaxed);
+    this->m_deq_idx.store(i + count, release);
+    return i;
+  } else {
+    return this->m_deq_idx.fetch_add(count, seq_cst);
+  }
+}
+
+template <typename Config>
+bool erased_queue_t<Config>::claim_cell(cell_ref_t cell) noexcept {
+  if constexpr (SINGLE_CONSUMER) {
+    return true;
+  } else {
+    deq_req_t* cd = nullptr;
+    return cell.deq_req.compare_exchange_strong(cd, top_ptr<deq_req_t>(), relaxed, relaxed);
+  }
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::deq(handle_type& th, bool& fast) {
+  std::intmax_t id = 0;
+  void* res = nullptr;
+
+  for (std::size_t patience = 0; patience < PATIENCE; ++patience) {
+    res = this->deq_fast(th, id);
+    backoff_type::record(th.backoff, res == top_ptr<void>());
+    if (res != top_ptr<void>()) {
+      break;
+    }
+
+    if (patience + 1 < PATIENCE) {
+      spin(backoff_type::spins(th.backoff));
+    }
+  }
+
+  fast = res != top_ptr<void>();
+  if (!fast) {
+    th.counters.add(counter_t::slow_dequeues);
+    res = this->deq_slow(th, id);
+  } else {
+    th.counters.add(counter_t::fast_dequeues);
+  }
+
+  return res;
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::deq_fast(handle_type& th, std::intmax_t& id) {
+  // increment dequeue index
+  const auto i = this->claim_deq_idx(1);
+  auto [cell, curr] = find_cell(th.head, th, this->m_node_pool, this->m_directory, i);
+  th.head.store(&curr, relaxed);
+  void* res = this->help_enq(cell, th, i);
+
+  if (res == nullptr) {
+    return nullptr;
+  }
+
+  if (res != top_ptr<void>() && this->claim_cell(cell)) {
+    return res;
+  }
+
+  id = i;
+  return top_ptr<void>();
+}
+
+template <typename Config>
+void* erased_queue_t<Config>::deq_slow(handle_type& th, std::intmax_t id) {
+  if constexpr (SINGLE_CONSUMER) {
+    // without other dequeuers there is no request to publish, so the consumer walks the cells
+    // after its last failed attempt itself, each visit helps a pending enqueue request, so every
+    // enqueuer which abandoned a cell has its element placed within a bounded number of cells
+    for (auto i = id + 1;; ++i) {
+      if (this->m_deq_idx.load(relaxed) <= i) {
+        this->m_deq_idx.store(i + 1, release);
+      }
+
+      auto [cell, curr] = find_cell(th.head, th, this->m_node_pool, this->m_directory, i);
+      th.head.store(&curr, relaxed);
+      if (auto res = this->help_enq(cell, th, i); res != top_ptr<void>()) {
+        return res;
+      }
+    }
+  }
+
+  auto& deq = th.deq_req;
+  deq.id.store(id, release);
+  deq.idx.store(id, release);
+
+  this->help_deq(th, th);
+
+  const auto i = -1 * deq.idx.load(relaxed);
+  auto [cell, curr] = find_cell(th.head, th, this->m_node_pool, this->m_directory, i);
+  th.head.store(&curr, relaxed);
+  auto res = cell.val.load(relaxed);
+
+  return res == top_ptr<void>() ? nullptr : res;
+}
+
+template <typename Config>
+void erased_queue_t<Config>::help_deq(handle_type& th, handle_type& ph) {
+  auto& deq = ph.deq_req;
+  auto idx = deq.idx.load(acquire);
+  const auto id = deq.id.load(relaxed);
+
+  if (idx < id) {
+    return;
+  }
+
+  if (&ph != &th) {
+    th.counters.add(counter_t::helps);
+  }
+
+  const auto lDp = ph.head.load(relaxed);
+  // with epoch-based reclamation, the helper's own epoch already protects the peer's nodes
+  if constexpr (!reclaim_type::EPOCH) {
+    const auto hzd_node_id = ph.hzd_node_id.load(relaxed);
+    th.hzd_node_id.store(hzd_node_id, seq_cst);
+  }
+  idx = deq.idx.load(relaxed);
+
+  auto i = id + 1;
+  auto old_val = id;
+  auto new_val = 0;
+
+  while (true) {
+    for (; idx == old_val && new_val == 0; ++i) {
+      auto [cell, _ignore] = find_cell(ph.head, th, this->m_node_pool, this->m_directory, i);
+
+      auto lDi = this->m_deq_idx.load(relaxed);
+      while (lDi <= i && !this->m_deq_idx.compare_exchange_weak(lDi, i + 1, relaxed, relaxed)) {}
+
+      auto res = this->help_enq(cell, th, i);
+      if (res == nullptr || (res != top_ptr<void>() && cell.deq_req.load(relaxed) == nullptr)) {
+        new_val = i;
+      } else {
+        idx = deq.idx.load(acquire);
+      }
+    }
+
+    if (new_val != 0) {
+      if (deq.idx.compare_exchange_strong(idx, new_val, release, acquire)) {
+        idx = new_val;
+      }
+
+      if (idx >= new_val) {
+        new_val = 0;
+      }
+    }
+
+    if (idx < 0 || deq.id.load(relaxed) != id) {
+      break;
+    }
+
+    auto [cell, _ignore] = find_cell(ph.head, th, this->m_node_pool, this->m_directory, idx);
+    deq_req_t* cd = nullptr;
+    if (
+        cell.val.load(relaxed) == top_ptr<void>() ||
+        cell.deq_req.compare_exchange_strong(cd, &deq, relaxed, relaxed) ||
+        cd == &deq
+    ) {
+      deq.idx.compare_exchange_strong(idx, -idx, relaxed, relaxed);
+      break;
+    }
+
+    old_val = idx;
+    if (idx >= i) {
+      i = idx + 1;
+    }
+  }
+}
 }
 
 #endif /* YMC_ERASED_QUEUE_HPP */
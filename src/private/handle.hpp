@@ -2,47 +2,56 @@
 #define YMC_QUEUE_HANDLE_HPP
 
 #include <atomic>
+#include <memory>
 #include <limits>
-#include <vector>
 
 #include "private/detail.hpp"
-#include "private/node.hpp"
+#include "private/latency.hpp"
+#include "private/stats.hpp"
 
 namespace ymc::detail {
 constexpr auto MAX_U64 = std::numeric_limits<uint64_t>::max();
+template <typename Node>
 struct handle_t {
-  /** constructor */
-  handle_t(node_t* node, std::size_t max_threads):
-      tail{ node }, head{ node }, peer_handles{ max_threads }
-  {
-    for (auto i = 0; i < max_threads; ++i) {
-      this->peer_handles.push_back(nullptr);
-    }
-  }
-
-  /** Pointer to the next handle. */
+  /** Pointer to the next handle, all handles form a static ring traversed by cleanup. */
   handle_t* next{ nullptr };
+  /** Pointer to the next handle to help, only registered handles form the helping ring. */
+  std::atomic<handle_t*> help_next{ nullptr };
   /** Hazard pointer. */
   std::atomic_uintmax_t hzd_node_id{ MAX_U64 };
+  /** The epoch announced during an operation with epoch-based reclamation, `MAX_U64` if idle. */
+  std::atomic_uint64_t epoch{ MAX_U64 };
   /** Pointer to the node for enqueue. */
-  std::atomic<node_t*> tail;
+  std::atomic<Node*> tail{ nullptr };
   std::uintmax_t tail_node_id{ 0 };
   /** Pointer to the node for dequeue. */
-  std::atomic<node_t*> head;
+  std::atomic<Node*> head{ nullptr };
   std::uintmax_t head_node_id{ 0 };
   /** Enqueue request. */
   alignas(64) enq_req_t enq_req{ 0, nullptr };
   /** Dequeue request. */
   alignas(64) deq_req_t deq_req{ 0, -1 };
-  /** Handle of the next enqueue to help. */
-  alignas(64) handle_t* enq_help_handle{ nullptr };
+  /** Operation counters on their own cache line, which take no space if compiled out. */
+  [[no_unique_address]] handle_counters_t counters{};
+  /**
+   * Handle of the next enqueue to help, this and the following fields are only accessed by the
+   * owning thread, so they share the counters' cache line, which is likewise only written by it.
+   */
+  handle_t* enq_help_handle{ nullptr };
   intmax_t Ei{ 0 };
   /** Handle of the next dequeue to help. */
   handle_t* deq_help_handle{ nullptr };
-  /** Pointer to a spare node to use, to speedup adding a new node. */
-  node_t* spare_node{ new node_t() };
-  /** Storage for temporary thread handles during cleanup. */
-  std::vector<handle_t*> peer_handles;
+  /** Pointer to a spare node to use, to speedup adding a new node, acquired on first use. */
+  Node* spare_node{ nullptr };
+  /** The state of the queue's backoff policy, e.g. the recent rate of fast-path failures. */
+  std::uint32_t backoff{ 0 };
+#if YMC_QUEUE_LATENCY
+  /**
+   * Latency histograms, allocated on the handle's first recorded operation and owned by the
+   * queue, nullptr until then.
+   */
+  std::atomic<handle_latencies_t*> latencies{ nullptr };
+#endif
 };
 }
 
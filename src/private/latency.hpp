@@ -0,0 +1,202 @@
+#ifndef YMC_QUEUE_LATENCY_HPP
+#define YMC_QUEUE_LATENCY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/** Operation latencies are recorded only if `YMC_QUEUE_LATENCY` is defined as non-zero. */
+#ifndef YMC_QUEUE_LATENCY
+#define YMC_QUEUE_LATENCY 0
+#endif
+
+namespace ymc::detail {
+/** Reads the CPU's timestamp counter, or a nanosecond clock where none is accessible. */
+inline std::uint64_t read_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now);
+  return static_cast<std::uint64_t>(ns.count());
+#endif
+}
+
+/**
+ * The log-linear bucketing of a latency histogram: values below `SUB_BUCKETS` are counted
+ * exactly, larger values in `SUB_BUCKETS` linear sub-buckets per power of two, i.e., with a
+ * relative error of at most 1/16.
+ */
+struct latency_buckets_t {
+  static constexpr std::size_t SUB_BUCKET_BITS = 4;
+  static constexpr std::size_t SUB_BUCKETS = std::size_t{ 1 } << SUB_BUCKET_BITS;
+  static constexpr std::size_t COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  /** Returns the index of the bucket counting `value`. */
+  static constexpr std::size_t index_of(std::uint64_t value) noexcept {
+    if (value < SUB_BUCKETS) {
+      return static_cast<std::size_t>(value);
+    }
+
+    const auto shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS;
+    const auto sub = static_cast<std::size_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+  }
+
+  /** Returns the largest value counted by the bucket with the given index. */
+  static constexpr std::uint64_t upper_bound_of(std::size_t index) noexcept {
+    if (index < SUB_BUCKETS) {
+      return index;
+    }
+
+    const auto shift = index / SUB_BUCKETS - 1;
+    const auto sub = (index % SUB_BUCKETS) | SUB_BUCKETS;
+    return ((static_cast<std::uint64_t>(sub) + 1) << shift) - 1;
+  }
+};
+
+/** Percentiles of a latency histogram, in timestamp counter ticks. */
+struct latency_summary_t {
+  std::uint64_t count{ 0 };
+  std::uint64_t p50{ 0 };
+  std::uint64_t p99{ 0 };
+  std::uint64_t p999{ 0 };
+  std::uint64_t max{ 0 };
+};
+
+/** A mergeable snapshot of a log-linear latency histogram. */
+class latency_histogram_t {
+  std::array<std::uint64_t, latency_buckets_t::COUNT> m_buckets{};
+  std::uint64_t m_count{ 0 };
+  std::uint64_t m_max{ 0 };
+
+public:
+  /** Records a single value. */
+  void record(std::uint64_t value) noexcept {
+    this->add(latency_buckets_t::index_of(value), 1, value);
+  }
+
+  /** Adds `count` values to the bucket with the given index, of which `max` is the largest. */
+  void add(std::size_t index, std::uint64_t count, std::uint64_t max) noexcept {
+    this->m_buckets[index] += count;
+    this->m_count += count;
+    this->m_max = std::max(this->m_max, max);
+  }
+
+  /** Adds all values recorded by `other`. */
+  void merge(const latency_histogram_t& other) noexcept {
+    for (std::size_t i = 0; i < latency_buckets_t::COUNT; ++i) {
+      this->m_buckets[i] += other.m_buckets[i];
+    }
+
+    this->m_count += other.m_count;
+    this->m_max = std::max(this->m_max, other.m_max);
+  }
+
+  /** Returns the number of recorded values. */
+  std::uint64_t count() const noexcept {
+    return this->m_count;
+  }
+
+  /** Returns the largest recorded value. */
+  std::uint64_t max() const noexcept {
+    return this->m_max;
+  }
+
+  /**
+   * Returns the value at the given quantile `q` (in [0, 1]), i.e., the upper bound of the bucket
+   * containing it, or 0 if no values have been recorded.
+   */
+  std::uint64_t percentile(double q) const noexcept {
+    if (this->m_count == 0) {
+      return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(q * static_cast<double>(this->m_count) + 0.5)
+    );
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < latency_buckets_t::COUNT; ++i) {
+      seen += this->m_buckets[i];
+      if (seen >= rank) {
+        return std::min(latency_buckets_t::upper_bound_of(i), this->m_max);
+      }
+    }
+
+    return this->m_max;
+  }
+
+  /** Returns the p50/p99/p99.9/max summary of the histogram. */
+  latency_summary_t summary() const noexcept {
+    return {
+      this->m_count,
+      this->percentile(0.5),
+      this->percentile(0.99),
+      this->percentile(0.999),
+      this->m_max,
+    };
+  }
+};
+
+/**
+ * A latency histogram written by a single thread, which may be merged into snapshots by other
+ * threads concurrently.
+ */
+class latency_recorder_t {
+  std::array<std::atomic_uint64_t, latency_buckets_t::COUNT> m_buckets{};
+  std::atomic_uint64_t m_max{ 0 };
+
+public:
+  /** Records a single value, must only be called by the owning thread. */
+  void record(std::uint64_t value) noexcept {
+    auto& bucket = this->m_buckets[latency_buckets_t::index_of(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (value > this->m_max.load(std::memory_order_relaxed)) {
+      this->m_max.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /** Adds all values recorded so far to the given snapshot. */
+  void merge_into(latency_histogram_t& histogram) const noexcept {
+    const auto max = this->m_max.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < latency_buckets_t::COUNT; ++i) {
+      const auto count = this->m_buckets[i].load(std::memory_order_relaxed);
+      if (count != 0) {
+        histogram.add(i, count, std::min(latency_buckets_t::upper_bound_of(i), max));
+      }
+    }
+  }
+};
+
+/** The latency recorders of a single thread handle. */
+struct handle_latencies_t {
+  latency_recorder_t fast_enqueue{};
+  latency_recorder_t slow_enqueue{};
+  latency_recorder_t fast_dequeue{};
+  latency_recorder_t slow_dequeue{};
+};
+
+/** Snapshots of a queue's latency histograms, merged over all thread handles. */
+struct queue_latencies_t {
+  /** Whether latencies are recorded, all histograms are empty otherwise. */
+  bool enabled{ YMC_QUEUE_LATENCY != 0 };
+  latency_histogram_t fast_enqueue{};
+  latency_histogram_t slow_enqueue{};
+  latency_histogram_t fast_dequeue{};
+  latency_histogram_t slow_dequeue{};
+};
+}
+
+#endif /* YMC_QUEUE_LATENCY_HPP */
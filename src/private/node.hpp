@@ -3,7 +3,9 @@
 
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cstdint>
+#include <numeric>
 
 #include "private/detail.hpp"
 
@@ -14,10 +16,128 @@ struct alignas(64) cell_t {
   std::atomic<deq_req_t*> deq_req{ nullptr };
 };
 
+/** A cell without any padding. */
+struct packed_cell_t {
+  std::atomic<void*> val{ nullptr };
+  std::atomic<enq_req_t*> enq_req{ nullptr };
+  std::atomic<deq_req_t*> deq_req{ nullptr };
+};
+
+/** References to the fields of a single cell, regardless of the node's cell layout. */
+struct cell_ref_t {
+  std::atomic<void*>& val;
+  std::atomic<enq_req_t*>& enq_req;
+  std::atomic<deq_req_t*>& deq_req;
+};
+
+/** Resets all fields of the referenced cell. */
+inline void reset_cell(cell_ref_t cell) noexcept {
+  cell.val.store(nullptr, std::memory_order_relaxed);
+  cell.enq_req.store(nullptr, std::memory_order_relaxed);
+  cell.deq_req.store(nullptr, std::memory_order_relaxed);
+}
+
+/** Each cell is padded to its own cache line (the original layout). */
+struct padded_layout_t {
+  template <std::size_t N>
+  struct cells_t {
+    std::array<cell_t, N> cells{};
+
+    cell_ref_t operator[](std::size_t pos) noexcept {
+      auto& cell = this->cells[pos];
+      return { cell.val, cell.enq_req, cell.deq_req };
+    }
+  };
+};
+
+/**
+ * The cell fields are split into separate arrays, so the values accessed by the fast paths are
+ * stored densely, apart from the request pointers only accessed by the slow paths.
+ */
+struct split_layout_t {
+  template <std::size_t N>
+  struct cells_t {
+    alignas(64) std::array<std::atomic<void*>, N> vals{};
+    alignas(64) std::array<std::atomic<enq_req_t*>, N> enq_reqs{};
+    alignas(64) std::array<std::atomic<deq_req_t*>, N> deq_reqs{};
+
+    cell_ref_t operator[](std::size_t pos) noexcept {
+      return { this->vals[pos], this->enq_reqs[pos], this->deq_reqs[pos] };
+    }
+  };
+};
+
+/**
+ * Cells are stored without padding, but cell positions are swizzled by a stride spanning at least
+ * one cache line, so cells for consecutive indices still lie on different cache lines.
+ */
+struct dense_layout_t {
+  template <std::size_t N>
+  struct cells_t {
+    /** The smallest stride covering a cache line, which is coprime to N (i.e., a permutation). */
+    static constexpr std::size_t STRIDE = [] {
+      auto stride = (64 + sizeof(packed_cell_t) - 1) / sizeof(packed_cell_t);
+      while (std::gcd(stride, N) != 1) {
+        stride += 1;
+      }
+
+      return stride;
+    }();
+
+    std::array<packed_cell_t, N> cells{};
+
+    cell_ref_t operator[](std::size_t pos) noexcept {
+      std::size_t swizzled;
+      if constexpr (std::has_single_bit(N)) {
+        swizzled = (pos * STRIDE) & (N - 1);
+      } else {
+        swizzled = (pos * STRIDE) % N;
+      }
+
+      auto& cell = this->cells[swizzled];
+      return { cell.val, cell.enq_req, cell.deq_req };
+    }
+  };
+};
+
+template <std::size_t NodeSize, typename Layout = padded_layout_t>
 struct node_t {
+  static_assert(NodeSize > 0, "nodes must contain at least one cell");
+
+  /** The number of cells per node. */
+  static constexpr std::size_t SIZE = NodeSize;
+
   alignas(64) std::atomic<node_t*> next{nullptr};
   alignas(64) std::intmax_t id{ 0 };
-  alignas(64) std::array<cell_t, NODE_SIZE> cells{};
+  alignas(64) typename Layout::template cells_t<NodeSize> cells{};
+
+  /** Returns the id of the node containing the cell for the (non-negative) index `idx`. */
+  static constexpr std::intmax_t node_id_of(std::intmax_t idx) noexcept {
+    if constexpr (std::has_single_bit(NodeSize)) {
+      constexpr auto shift = std::countr_zero(NodeSize);
+      return static_cast<std::intmax_t>(static_cast<std::uintmax_t>(idx) >> shift);
+    } else {
+      return idx / static_cast<std::intmax_t>(NodeSize);
+    }
+  }
+
+  /** Returns the position of the cell for the (non-negative) index `idx` within its node. */
+  static constexpr std::size_t cell_of(std::intmax_t idx) noexcept {
+    if constexpr (std::has_single_bit(NodeSize)) {
+      return static_cast<std::size_t>(idx) & (NodeSize - 1);
+    } else {
+      return static_cast<std::size_t>(idx % static_cast<std::intmax_t>(NodeSize));
+    }
+  }
+
+  /** Resets the node to its freshly constructed state, so it can be reused. */
+  void reset() noexcept {
+    this->next.store(nullptr, std::memory_order_relaxed);
+    this->id = 0;
+    for (std::size_t i = 0; i < NodeSize; ++i) {
+      reset_cell(this->cells[i]);
+    }
+  }
 };
 }
 
@@ -0,0 +1,89 @@
+#ifndef YMC_QUEUE_NODE_ARENA_HPP
+#define YMC_QUEUE_NODE_ARENA_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace ymc::detail {
+/** The source of a queue's node memory. */
+enum class node_memory_t {
+  /** Nodes are allocated individually from the heap. */
+  heap,
+  /** Nodes are carved out of NUMA-local 2 MiB (huge page) regions. */
+  huge_pages,
+};
+
+/**
+ * An arena carving equally sized node slots out of 2 MiB regions, which are backed by explicit
+ * huge pages if available and transparent huge pages otherwise.
+ *
+ * Each region is bound to the NUMA node of the thread that mapped it and allocations are served
+ * from regions local to the calling thread, unless the arena is bound to a fixed NUMA node, which
+ * all its regions are bound to. Once all nodes of a region are freed, its memory is returned to
+ * the OS with `madvise`, but the mapping is retained for reuse.
+ */
+class node_arena_t {
+public:
+  /** The size (and alignment) of each region. */
+  static constexpr std::size_t REGION_SIZE = std::size_t{ 2 } << 20;
+
+  /** constructor & destructor */
+  explicit node_arena_t(std::size_t node_size, std::optional<unsigned> numa_node = std::nullopt);
+  ~node_arena_t() noexcept;
+
+  /** Allocates uninitialized memory for a node from a region local to the calling thread. */
+  void* allocate();
+  /** Returns the memory of an already destroyed node to its region. */
+  void deallocate(void* node) noexcept;
+  /**
+   * Returns the number of bytes of all regions currently holding memory, i.e., all regions with at
+   * least one allocated node, released regions remain mapped but are not counted.
+   */
+  std::size_t resident_bytes() const noexcept {
+    return this->m_resident.load(std::memory_order_relaxed) * REGION_SIZE;
+  }
+
+  node_arena_t(const node_arena_t&)                  = delete;
+  node_arena_t(node_arena_t&&)                       = delete;
+  const node_arena_t& operator=(const node_arena_t&) = delete;
+  const node_arena_t& operator=(node_arena_t&&)      = delete;
+
+private:
+  struct free_slot_t {
+    free_slot_t* next;
+  };
+
+  struct region_t {
+    /** The region's base address. */
+    std::byte* base;
+    /** The NUMA node the region is bound to. */
+    unsigned numa_node;
+    /** The number of currently allocated nodes. */
+    std::size_t live{ 0 };
+    /** The number of slots that have been handed out at least once since the last release. */
+    std::size_t bump{ 0 };
+    /** List of freed slots. */
+    free_slot_t* free_list{ nullptr };
+  };
+
+  /** Maps a new region bound to the given NUMA node. */
+  region_t& map_region(unsigned numa_node);
+
+  /** The size of each node slot. */
+  std::size_t m_node_size;
+  /** The number of node slots fitting into each region. */
+  std::size_t m_nodes_per_region;
+  /** The NUMA node all regions are bound to, if any. */
+  std::optional<unsigned> m_numa_node;
+  /** The number of regions with at least one allocated node. */
+  std::atomic_size_t m_resident{ 0 };
+  std::mutex m_mutex{};
+  std::unordered_map<std::uintptr_t, std::unique_ptr<region_t>> m_regions{};
+};
+}
+
+#endif /* YMC_QUEUE_NODE_ARENA_HPP */
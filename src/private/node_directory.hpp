@@ -0,0 +1,62 @@
+#ifndef YMC_QUEUE_NODE_DIRECTORY_HPP
+#define YMC_QUEUE_NODE_DIRECTORY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ymc::detail {
+/**
+ * A lock-free directory of the most recently linked nodes, which maps node ids to nodes in O(1)
+ * instead of walking the list.
+ *
+ * The directory is a ring of `Slots` words, each holding a node pointer in its lower 48 bits and
+ * a tag of the node id's upper bits in its upper 16 bits, so a lookup never dereferences a node
+ * with a different id. Slots are overwritten once `Slots` newer nodes have been linked, lookups
+ * of older (or unpublished) nodes miss and callers fall back to walking the list.
+ *
+ * A lookup only returns nodes whose id matches the tag (unless `2^16 * Slots` nodes have been
+ * linked in the meantime), so the result is valid whenever the caller already protects the
+ * requested node id from reclamation, i.e., whenever it could have walked to the node instead.
+ */
+template <typename Node, std::size_t Slots>
+class node_directory_t {
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "slot count must be a power of two");
+  static_assert(sizeof(void*) == sizeof(std::uint64_t), "node directory requires 64-bit pointers");
+
+  static constexpr unsigned TAG_SHIFT = 48;
+  static constexpr std::uint64_t PTR_MASK = (std::uint64_t{ 1 } << TAG_SHIFT) - 1;
+
+  alignas(64) std::array<std::atomic_uint64_t, Slots> m_slots{};
+
+  static constexpr std::uint64_t tag_of(std::intmax_t id) noexcept {
+    return (static_cast<std::uint64_t>(id) / Slots) & 0xFFFF;
+  }
+
+  std::atomic_uint64_t& slot_of(std::intmax_t id) noexcept {
+    return this->m_slots[static_cast<std::uint64_t>(id) & (Slots - 1)];
+  }
+
+public:
+  /** Publishes the given linked node, unless its address does not fit into 48 bits. */
+  void publish(Node* node) noexcept {
+    const auto addr = reinterpret_cast<std::uint64_t>(node);
+    if ((addr & ~PTR_MASK) == 0) {
+      const auto word = (tag_of(node->id) << TAG_SHIFT) | addr;
+      this->slot_of(node->id).store(word, std::memory_order_release);
+    }
+  }
+
+  /** Returns the published node with the given id, nullptr if it is not (or no longer) published. */
+  Node* find(std::intmax_t id) noexcept {
+    const auto word = this->slot_of(id).load(std::memory_order_acquire);
+    if ((word >> TAG_SHIFT) != tag_of(id)) {
+      return nullptr;
+    }
+
+    return reinterpret_cast<Node*>(word & PTR_MASK);
+  }
+};
+}
+
+#endif /* YMC_QUEUE_NODE_DIRECTORY_HPP */
@@ -0,0 +1,300 @@
+#ifndef YMC_QUEUE_NODE_POOL_HPP
+#define YMC_QUEUE_NODE_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+
+#include "private/node.hpp"
+#include "private/node_arena.hpp"
+
+namespace ymc::detail {
+/** Statistics of a queue's node pool. */
+struct node_pool_stats_t {
+  /** Number of node requests served from the pool. */
+  std::size_t hits;
+  /** Number of node requests that had to allocate a new node. */
+  std::size_t misses;
+  /** Approximate number of nodes currently held by the pool. */
+  std::size_t size;
+  /** Maximum number of nodes retained by the pool, surplus nodes are freed. */
+  std::size_t high_watermark;
+};
+
+/**
+ * A bounded pool of reset nodes, which are recycled by the queue's memory reclamation instead of
+ * being freed.
+ *
+ * The pool is a lock-free bounded ring of node pointers with per-slot sequence numbers, so
+ * neither `acquire` nor `release` ever dereference nodes owned by other threads and the pool is
+ * not susceptible to ABA issues.
+ *
+ * The pool can limit the number of live nodes, which `try_acquire` and `reserve` never exceed,
+ * whereas `acquire` allocates beyond the limit, since its callers cannot proceed without a node.
+ */
+template <typename Node>
+class node_pool_t {
+  struct slot_t {
+    std::atomic_size_t seq;
+    Node* node;
+  };
+
+  /** The arena to allocate nodes from, nullptr if nodes are allocated from the heap. */
+  std::unique_ptr<node_arena_t> m_arena;
+  /** The ring of slots, `m_capacity` in size. */
+  std::unique_ptr<slot_t[]> m_slots;
+  std::size_t m_capacity;
+  /** Position of the next slot to release a node into. */
+  alignas(64) std::atomic_size_t m_push_pos{ 0 };
+  /** Position of the next slot to acquire a node from. */
+  alignas(64) std::atomic_size_t m_pop_pos{ 0 };
+  /** Hit/miss counters. */
+  alignas(64) std::atomic_size_t m_hits{ 0 };
+  std::atomic_size_t m_misses{ 0 };
+  /** Number of nodes allocated and not yet freed, whether linked, spare or pooled. */
+  std::atomic_size_t m_live{ 0 };
+  /** The maximum number of live nodes for `try_acquire` and `reserve`. */
+  std::size_t m_limit{ std::numeric_limits<std::size_t>::max() };
+
+  /** Allocates a new zeroed node without counting it as live. */
+  Node* make_node() {
+    return this->m_arena != nullptr ? ::new (this->m_arena->allocate()) Node() : new Node();
+  }
+
+  /** Allocates a new zeroed node, unless the limit of live nodes has been reached. */
+  Node* try_allocate() {
+    auto live = this->m_live.load(std::memory_order_relaxed);
+    do {
+      if (live >= this->m_limit) {
+        return nullptr;
+      }
+    } while (!this->m_live.compare_exchange_weak(live, live + 1, std::memory_order_relaxed));
+
+    try {
+      return this->make_node();
+    } catch (...) {
+      this->m_live.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+  }
+
+  /** Attempts to pop a node from the ring, returns nullptr if the ring is empty. */
+  Node* try_pop() noexcept {
+    if (this->m_capacity == 0) {
+      return nullptr;
+    }
+
+    auto pos = this->m_pop_pos.load(std::memory_order_relaxed);
+    while (true) {
+      auto& slot = this->m_slots[pos % this->m_capacity];
+      const auto seq = slot.seq.load(std::memory_order_acquire);
+      const auto dif = static_cast<std::intmax_t>(seq) - static_cast<std::intmax_t>(pos + 1);
+
+      if (dif == 0) {
+        if (this->m_pop_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          auto node = slot.node;
+          slot.seq.store(pos + this->m_capacity, std::memory_order_release);
+          return node;
+        }
+      } else if (dif < 0) {
+        return nullptr;
+      } else {
+        pos = this->m_pop_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** Attempts to push a node into the ring, returns false if the ring is full. */
+  bool try_push(Node* node) noexcept {
+    if (this->m_capacity == 0) {
+      return false;
+    }
+
+    auto pos = this->m_push_pos.load(std::memory_order_relaxed);
+    while (true) {
+      auto& slot = this->m_slots[pos % this->m_capacity];
+      const auto seq = slot.seq.load(std::memory_order_acquire);
+      const auto dif = static_cast<std::intmax_t>(seq) - static_cast<std::intmax_t>(pos);
+
+      if (dif == 0) {
+        if (this->m_push_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot.node = node;
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = this->m_push_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+public:
+  /** constructor & destructor */
+  node_pool_t(
+      std::size_t high_watermark,
+      node_memory_t memory,
+      std::optional<unsigned> numa_node = std::nullopt
+  ):
+    m_arena{
+      memory == node_memory_t::huge_pages
+          ? std::make_unique<node_arena_t>(sizeof(Node), numa_node)
+          : nullptr
+    },
+    m_slots{ std::make_unique<slot_t[]>(high_watermark) },
+    m_capacity{ high_watermark }
+  {
+    for (std::size_t i = 0; i < high_watermark; ++i) {
+      this->m_slots[i].seq.store(i, std::memory_order_relaxed);
+      this->m_slots[i].node = nullptr;
+    }
+  }
+
+  ~node_pool_t() noexcept {
+    this->trim();
+  }
+
+  /** Returns a zeroed node, either from the pool or freshly allocated. */
+  Node* acquire() {
+    if (auto node = this->try_pop(); node != nullptr) {
+      this->m_hits.fetch_add(1, std::memory_order_relaxed);
+      return node;
+    }
+
+    this->m_misses.fetch_add(1, std::memory_order_relaxed);
+    return this->allocate();
+  }
+
+  /**
+   * Returns a zeroed node like `acquire`, unless the pool is empty and the limit of live nodes has
+   * been reached, in which case nullptr is returned.
+   */
+  Node* try_acquire() {
+    if (auto node = this->try_pop(); node != nullptr) {
+      this->m_hits.fetch_add(1, std::memory_order_relaxed);
+      return node;
+    }
+
+    auto node = this->try_allocate();
+    if (node != nullptr) {
+      this->m_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return node;
+  }
+
+  /** Returns true if the pool appears empty and no more nodes can be acquired within the limit. */
+  bool exhausted() const noexcept {
+    return this->m_live.load(std::memory_order_relaxed) >= this->m_limit
+        && this->stats().size == 0;
+  }
+
+  /** Limits the number of live nodes for `try_acquire` and `reserve` to `nodes`. */
+  void limit(std::size_t nodes) noexcept {
+    this->m_limit = nodes;
+  }
+
+  /** Resets the given unreachable node and returns it to the pool or frees it, if the pool is full. */
+  void release(Node* node) noexcept {
+    if (this->m_capacity == 0) {
+      this->deallocate(node);
+      return;
+    }
+
+    node->reset();
+    if (!this->try_push(node)) {
+      this->deallocate(node);
+    }
+  }
+
+  /** Allocates a new zeroed node, bypassing the pool. */
+  Node* allocate() {
+    auto node = this->make_node();
+    this->m_live.fetch_add(1, std::memory_order_relaxed);
+    return node;
+  }
+
+  /** Frees the given node, bypassing the pool. */
+  void deallocate(Node* node) noexcept {
+    this->m_live.fetch_sub(1, std::memory_order_relaxed);
+    if (this->m_arena != nullptr) {
+      node->~Node();
+      this->m_arena->deallocate(node);
+    } else {
+      delete node;
+    }
+  }
+
+  /**
+   * Allocates nodes into the pool until it holds `count` nodes, is full or the limit of live nodes
+   * has been reached, returns their number.
+   */
+  std::size_t reserve(std::size_t count) {
+    std::size_t reserved = 0;
+    while (this->stats().size < count) {
+      auto node = this->try_allocate();
+      if (node == nullptr) {
+        break;
+      }
+
+      if (!this->try_push(node)) {
+        this->deallocate(node);
+        break;
+      }
+
+      reserved += 1;
+    }
+
+    return reserved;
+  }
+
+  /** Frees all nodes currently held by the pool and returns their number. */
+  std::size_t trim() noexcept {
+    std::size_t count = 0;
+    while (auto node = this->try_pop()) {
+      this->deallocate(node);
+      count += 1;
+    }
+
+    return count;
+  }
+
+  /**
+   * Returns the approximate number of bytes held by the pool's ring and all nodes allocated through
+   * the pool, which includes nodes linked into the queue and held as spares.
+   *
+   * With an arena, nodes are counted by the regions holding them, since a region's memory is only
+   * returned once all its nodes have been freed.
+   */
+  std::size_t memory_footprint() const noexcept {
+    const auto nodes = this->m_arena != nullptr
+        ? this->m_arena->resident_bytes()
+        : this->m_live.load(std::memory_order_relaxed) * sizeof(Node);
+    return this->m_capacity * sizeof(slot_t) + nodes;
+  }
+
+  /** Returns the pool's current statistics. */
+  node_pool_stats_t stats() const noexcept {
+    const auto push = this->m_push_pos.load(std::memory_order_relaxed);
+    const auto pop = this->m_pop_pos.load(std::memory_order_relaxed);
+
+    return {
+      this->m_hits.load(std::memory_order_relaxed),
+      this->m_misses.load(std::memory_order_relaxed),
+      push > pop ? push - pop : 0,
+      this->m_capacity,
+    };
+  }
+
+  node_pool_t(const node_pool_t&)                  = delete;
+  node_pool_t(node_pool_t&&)                       = delete;
+  const node_pool_t& operator=(const node_pool_t&) = delete;
+  const node_pool_t& operator=(node_pool_t&&)      = delete;
+};
+}
+
+#endif /* YMC_QUEUE_NODE_POOL_HPP */
@@ -0,0 +1,14 @@
+#ifndef YMC_QUEUE_NUMA_HPP
+#define YMC_QUEUE_NUMA_HPP
+
+#include <cstdint>
+
+namespace ymc::detail {
+/** Returns the NUMA node of the CPU the calling thread currently runs on. */
+unsigned current_numa_node() noexcept;
+
+/** Returns the number of NUMA nodes of the system, at least one. */
+std::size_t numa_node_count() noexcept;
+}
+
+#endif /* YMC_QUEUE_NUMA_HPP */
@@ -0,0 +1,141 @@
+#ifndef YMC_QUEUE_PARKING_HPP
+#define YMC_QUEUE_PARKING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
+namespace ymc::detail {
+static_assert(
+    sizeof(std::atomic_uint32_t) == sizeof(std::uint32_t),
+    "parking requires lock-free 32-bit atomics"
+);
+
+/** Hints the CPU that the calling thread is spin-waiting. */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * Parks the calling thread until `word` no longer holds `expected`, it is woken up or the
+ * `deadline` (if any) has passed, spurious wake-ups are possible.
+ */
+inline void park(
+    std::atomic_uint32_t& word,
+    std::uint32_t expected,
+    std::optional<std::chrono::steady_clock::time_point> deadline
+) {
+#if defined(__linux__)
+  timespec timeout{};
+  timespec* timeout_ptr = nullptr;
+
+  if (deadline.has_value()) {
+    const auto remaining = *deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+      return;
+    }
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+    timeout.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    timeout.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    timeout_ptr = &timeout;
+  }
+
+  syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+      timeout_ptr, nullptr, 0
+  );
+#else
+  if (!deadline.has_value()) {
+    word.wait(expected);
+  } else if (word.load() == expected && std::chrono::steady_clock::now() < *deadline) {
+    std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+  }
+#endif
+}
+
+/** The maximum number of words `park_any` waits on at once. */
+constexpr std::size_t PARK_ANY_MAX = 128;
+
+/**
+ * Parks the calling thread until any of the first `count` (at most `PARK_ANY_MAX`) `words` no
+ * longer holds its `expected` value, it is woken up through any of them or the `deadline` (if any)
+ * has passed, spurious wake-ups are possible.
+ *
+ * Without vectorized futex waits (Linux 5.16 and later), the thread sleeps briefly instead.
+ */
+inline void park_any(
+    std::atomic_uint32_t* const* words,
+    const std::uint32_t* expected,
+    std::size_t count,
+    std::optional<std::chrono::steady_clock::time_point> deadline
+) {
+#if defined(__linux__) && defined(__NR_futex_waitv)
+  futex_waitv waiters[PARK_ANY_MAX]{};
+  for (std::size_t i = 0; i < count; ++i) {
+    waiters[i].val = expected[i];
+    waiters[i].uaddr = reinterpret_cast<std::uintptr_t>(words[i]);
+    waiters[i].flags = FUTEX_32 | FUTEX_PRIVATE_FLAG;
+  }
+
+  // the timeout is absolute, steady_clock is based on CLOCK_MONOTONIC
+  timespec timeout{};
+  timespec* timeout_ptr = nullptr;
+  if (deadline.has_value()) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline->time_since_epoch()).count();
+    timeout.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    timeout.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    timeout_ptr = &timeout;
+  }
+
+  if (
+      syscall(__NR_futex_waitv, waiters, count, 0, timeout_ptr, CLOCK_MONOTONIC) == 0
+      || errno != ENOSYS
+  ) {
+    return;
+  }
+#endif
+  for (std::size_t i = 0; i < count; ++i) {
+    if (words[i]->load() != expected[i]) {
+      return;
+    }
+  }
+
+  if (!deadline.has_value() || std::chrono::steady_clock::now() < *deadline) {
+    std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+  }
+}
+
+/** Wakes up to `count` threads parked on `word`. */
+inline void unpark(std::atomic_uint32_t& word, int count) noexcept {
+#if defined(__linux__)
+  syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count,
+      nullptr, nullptr, 0
+  );
+#else
+  if (count == 1) {
+    word.notify_one();
+  } else {
+    word.notify_all();
+  }
+#endif
+}
+}
+
+#endif /* YMC_QUEUE_PARKING_HPP */
@@ -0,0 +1,107 @@
+#ifndef YMC_QUEUE_RECLAIM_HPP
+#define YMC_QUEUE_RECLAIM_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace ymc::detail {
+/**
+ * The reclamation policy of the original algorithm: dequeuers run cleanup once the head has
+ * advanced `2 * max_threads` nodes beyond the last reclaimed node, which amortizes the scan of all
+ * thread handles, but retains up to that many nodes.
+ */
+struct hazard_reclaim_t {
+  /** Whether cleanup is run by a background thread instead of dequeuers. */
+  static constexpr bool BACKGROUND = false;
+  /** Whether operations announce the global epoch instead of their hazard node id. */
+  static constexpr bool EPOCH = false;
+
+  /** Returns the number of nodes the head has to advance before cleanup is attempted. */
+  static constexpr std::intmax_t threshold(std::size_t max_threads) noexcept {
+    return static_cast<std::intmax_t>(2 * max_threads);
+  }
+
+  /** Returns the number of nodes retained behind the head, unless a thread stalls. */
+  static constexpr std::intmax_t retained(std::size_t max_threads) noexcept {
+    return threshold(max_threads);
+  }
+};
+
+/**
+ * Dequeuers run cleanup once the head has advanced `Nodes` nodes, regardless of the number of
+ * thread handles, which bounds the retained memory at the cost of more frequent scans.
+ */
+template <std::size_t Nodes>
+struct eager_reclaim_t {
+  static_assert(Nodes > 0, "the reclamation threshold must be at least one node");
+
+  static constexpr bool BACKGROUND = false;
+  static constexpr bool EPOCH = false;
+
+  static constexpr std::intmax_t threshold(std::size_t) noexcept {
+    return static_cast<std::intmax_t>(Nodes);
+  }
+
+  static constexpr std::intmax_t retained(std::size_t max_threads) noexcept {
+    return threshold(max_threads);
+  }
+};
+
+/**
+ * The cleanup of `hazard_reclaim_t`, run every `IntervalMicros` microseconds by a background
+ * thread owned by the queue as soon as the head has advanced a single node, so dequeuers never
+ * scan the thread handles themselves.
+ *
+ * This is not epoch-based reclamation, nodes are still protected by the handles' hazard node ids
+ * and the background thread performs the same scan of all handles. While there is nothing to
+ * reclaim, the thread doubles its interval up to `IDLE_FACTOR` times, so idle queues are scanned
+ * rarely.
+ */
+template <std::size_t IntervalMicros>
+struct background_hazard_reclaim_t {
+  static_assert(IntervalMicros > 0, "the reclamation interval must be at least 1us");
+
+  static constexpr bool BACKGROUND = true;
+  /** The interval in which the background thread attempts cleanup while nodes are retired. */
+  static constexpr auto INTERVAL = std::chrono::microseconds{ IntervalMicros };
+  /** The maximum factor by which the interval grows while there is nothing to reclaim. */
+  static constexpr std::size_t IDLE_FACTOR = 64;
+  static constexpr bool EPOCH = false;
+
+  static constexpr std::intmax_t threshold(std::size_t) noexcept {
+    return 1;
+  }
+
+  static constexpr std::intmax_t retained(std::size_t max_threads) noexcept {
+    return threshold(max_threads);
+  }
+};
+
+/**
+ * Epoch-based reclamation: instead of its hazard node id, each operation announces the global
+ * epoch for its duration, which protects every node the operation can reach, including the nodes
+ * of peers it adopts while helping.
+ *
+ * Dequeuers run cleanup once the head has advanced `2 * max_threads` nodes, like
+ * `hazard_reclaim_t`. Cleanup only keeps the nodes from the head/tail pointers of handles in an
+ * operation onwards and advances idle handles unconditionally. The unlinked nodes are retired
+ * instead of freed and returned to the pool once the epoch has advanced twice, which cleanup
+ * attempts once per run. The epoch only advances while no operation announces an older one, so a
+ * thread stalled in an operation keeps all retired nodes from being reused.
+ */
+struct epoch_reclaim_t {
+  static constexpr bool BACKGROUND = false;
+  static constexpr bool EPOCH = true;
+
+  static constexpr std::intmax_t threshold(std::size_t max_threads) noexcept {
+    return static_cast<std::intmax_t>(2 * max_threads);
+  }
+
+  /** Nodes retired by the last two runs of cleanup wait for the epoch to advance. */
+  static constexpr std::intmax_t retained(std::size_t max_threads) noexcept {
+    return 3 * threshold(max_threads);
+  }
+};
+}
+
+#endif /* YMC_QUEUE_RECLAIM_HPP */
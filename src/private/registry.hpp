@@ -0,0 +1,103 @@
+#ifndef YMC_QUEUE_REGISTRY_HPP
+#define YMC_QUEUE_REGISTRY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ymc::detail {
+/** Returns a new process-wide unique queue instance id. */
+std::uintmax_t next_queue_instance() noexcept;
+
+/**
+ * The registration state of a queue's thread handles, which is shared with thread-local
+ * registrations, so these can detect if the queue has already been destroyed.
+ *
+ * The queue is referenced through an opaque pointer and callbacks, so thread-local registrations
+ * can be managed independently of the queue's configuration.
+ */
+struct handle_registry_t {
+  /** Guards all registration state, including the queue pointer. */
+  std::mutex mutex{};
+  /** The owning queue, nullptr once it has been destroyed. */
+  void* queue{ nullptr };
+  /** Claims an unused handle of the queue, called with the mutex held. */
+  std::size_t (*acquire_locked)(void* queue){ nullptr };
+  /** Releases a claimed handle of the queue, called with the mutex held. */
+  void (*release_locked)(void* queue, std::size_t thread_id){ nullptr };
+  /** A process-wide unique id for the owning queue. */
+  std::uintmax_t instance{ next_queue_instance() };
+
+  /** Claims an unused handle of the (live) queue. */
+  std::size_t acquire() {
+    std::lock_guard lock{ this->mutex };
+    return this->acquire_locked(this->queue);
+  }
+
+  /** Releases a claimed handle, unless the queue has already been destroyed. */
+  void release(std::size_t thread_id) noexcept {
+    std::lock_guard lock{ this->mutex };
+    if (this->queue != nullptr) {
+      this->release_locked(this->queue, thread_id);
+    }
+  }
+
+  /** Detaches the registry from its queue, which is being destroyed. */
+  void detach() noexcept {
+    std::lock_guard lock{ this->mutex };
+    this->queue = nullptr;
+  }
+};
+
+/** Returns the id of a handle claimed for the calling thread, claiming one on first use. */
+std::size_t thread_local_handle(const std::shared_ptr<handle_registry_t>& registry);
+
+/**
+ * A move-only claim of one of a queue's thread handles, which is released on destruction.
+ *
+ * The token shares ownership of the queue's registry, so it may outlive the queue, in which case
+ * destroying it releases nothing.
+ */
+class handle_token_t {
+  std::shared_ptr<handle_registry_t> m_registry{};
+  std::size_t m_id{ 0 };
+public:
+  handle_token_t() = default;
+  handle_token_t(std::shared_ptr<handle_registry_t> registry, std::size_t id) :
+    m_registry{ std::move(registry) }, m_id{ id } {}
+  ~handle_token_t() noexcept {
+    this->reset();
+  }
+
+  handle_token_t(handle_token_t&& other) noexcept :
+    m_registry{ std::move(other.m_registry) }, m_id{ other.m_id } {}
+
+  handle_token_t& operator=(handle_token_t&& other) noexcept {
+    if (this != &other) {
+      this->reset();
+      this->m_registry = std::move(other.m_registry);
+      this->m_id = other.m_id;
+    }
+
+    return *this;
+  }
+
+  handle_token_t(const handle_token_t&)            = delete;
+  handle_token_t& operator=(const handle_token_t&) = delete;
+
+  /** Returns the id of the claimed handle. */
+  std::size_t id() const noexcept { return this->m_id; }
+  /** Converts to the claimed handle's id, so tokens can be passed wherever a thread id is expected. */
+  operator std::size_t() const noexcept { return this->m_id; }
+
+  /** Releases the claimed handle, if any. */
+  void reset() noexcept {
+    if (auto registry = std::move(this->m_registry); registry != nullptr) {
+      registry->release(this->m_id);
+    }
+  }
+};
+}
+
+#endif /* YMC_QUEUE_REGISTRY_HPP */
@@ -0,0 +1,98 @@
+#ifndef YMC_QUEUE_STATS_HPP
+#define YMC_QUEUE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/** Per-handle operation counters are compiled in unless `YMC_QUEUE_STATS` is defined as 0. */
+#ifndef YMC_QUEUE_STATS
+#define YMC_QUEUE_STATS 1
+#endif
+
+namespace ymc::detail {
+/** The operation counters maintained by each thread handle. */
+enum class counter_t : std::size_t {
+  /** Enqueues completed on the fast path. */
+  fast_enqueues,
+  /** Enqueues which exhausted their patience and entered the slow path. */
+  slow_enqueues,
+  /** Dequeues completed on the fast path. */
+  fast_dequeues,
+  /** Dequeues which exhausted their patience and entered the slow path. */
+  slow_dequeues,
+  /** Pending requests of other threads this thread completed. */
+  helps,
+  /** Empty cells poisoned with TOP by this thread. */
+  cells_burned,
+  /** Nodes acquired from the node pool. */
+  nodes_allocated,
+  /** Nodes returned to the node pool by cleanup. */
+  nodes_freed,
+  /** Invocations of cleanup. */
+  cleanup_attempts,
+  /** Invocations of cleanup which reclaimed nodes. */
+  cleanup_successes,
+  /** The number of spare nodes currently held (0 or 1). */
+  spare_nodes,
+  COUNT,
+};
+
+/** A snapshot of a queue's counters, aggregated over all thread handles. */
+struct queue_stats_t {
+  /** Whether counters are compiled in, all counters are zero otherwise. */
+  bool enabled{ YMC_QUEUE_STATS != 0 };
+  std::uint64_t fast_enqueues{ 0 };
+  std::uint64_t slow_enqueues{ 0 };
+  std::uint64_t fast_dequeues{ 0 };
+  std::uint64_t slow_dequeues{ 0 };
+  std::uint64_t helps{ 0 };
+  std::uint64_t cells_burned{ 0 };
+  std::uint64_t nodes_allocated{ 0 };
+  std::uint64_t nodes_freed{ 0 };
+  std::uint64_t cleanup_attempts{ 0 };
+  std::uint64_t cleanup_successes{ 0 };
+  /** Bytes currently held in nodes linked into the queue. */
+  std::uint64_t node_bytes{ 0 };
+  /** Bytes currently held in thread handles' spare nodes. */
+  std::uint64_t spare_bytes{ 0 };
+};
+
+/**
+ * The counters of a single thread handle, which are only written by the thread owning the handle
+ * and may be read concurrently when aggregating a snapshot.
+ */
+class handle_counters_t {
+#if YMC_QUEUE_STATS
+  static constexpr auto COUNT = static_cast<std::size_t>(counter_t::COUNT);
+  alignas(64) std::array<std::atomic_uint64_t, COUNT> m_counters{};
+#endif
+public:
+  /** Adds `n` to the given counter. */
+  void add(counter_t counter, std::uint64_t n = 1) noexcept {
+#if YMC_QUEUE_STATS
+    // single writer, so no atomic read-modify-write is required
+    auto& c = this->m_counters[static_cast<std::size_t>(counter)];
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+#endif
+  }
+
+  /** Sets the given counter to `value`. */
+  void set(counter_t counter, std::uint64_t value) noexcept {
+#if YMC_QUEUE_STATS
+    this->m_counters[static_cast<std::size_t>(counter)].store(value, std::memory_order_relaxed);
+#endif
+  }
+
+  /** Returns the current value of the given counter. */
+  std::uint64_t get(counter_t counter) const noexcept {
+#if YMC_QUEUE_STATS
+    return this->m_counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+  }
+};
+}
+
+#endif /* YMC_QUEUE_STATS_HPP */
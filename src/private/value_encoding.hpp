@@ -0,0 +1,63 @@
+#ifndef YMC_QUEUE_VALUE_ENCODING_HPP
+#define YMC_QUEUE_VALUE_ENCODING_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ymc::detail {
+/** Whether values of type `T` can be stored inline in a cell, instead of a pointer. */
+template <typename T>
+inline constexpr bool is_inline_value_v =
+    std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*);
+
+/**
+ * Returns true if `value` collides with the encodings of the empty or TOP cell states, which is
+ * only possible for pointer-sized values with all bits set, except for the least significant one.
+ */
+template <typename T>
+bool is_reserved_value(const T& value) noexcept {
+  if constexpr (sizeof(T) < sizeof(void*)) {
+    return false;
+  } else {
+    std::uintptr_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits >= std::numeric_limits<std::uintptr_t>::max() - 1;
+  }
+}
+
+/**
+ * Encodes a value as a cell value, offset by one so that no encoding is nullptr (empty) or has all
+ * bits set (TOP), throws if `value` is one of the two reserved values.
+ */
+template <typename T>
+void* encode_value(const T& value) {
+  if (is_reserved_value(value)) {
+    throw std::invalid_argument("value collides with a reserved cell state");
+  }
+
+  std::uintptr_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(T));
+  return reinterpret_cast<void*>(bits + 1);
+}
+
+/** Decodes a cell value produced by `encode_value`, nullptr decodes to an empty optional. */
+template <typename T>
+std::optional<T> decode_value(void* encoded) noexcept {
+  if (encoded == nullptr) {
+    return std::nullopt;
+  }
+
+  const auto bits = reinterpret_cast<std::uintptr_t>(encoded) - 1;
+  std::array<unsigned char, sizeof(T)> bytes;
+  std::memcpy(bytes.data(), &bits, sizeof(T));
+  return std::bit_cast<T>(bytes);
+}
+}
+
+#endif /* YMC_QUEUE_VALUE_ENCODING_HPP */
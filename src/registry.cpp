@@ -0,0 +1,78 @@
+#include "private/registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace ymc::detail {
+namespace {
+/** The source of process-wide unique queue instance ids. */
+std::atomic_uintmax_t next_instance{ 1 };
+
+/** A thread's registration with a queue, which is released once the thread exits. */
+struct thread_registration_t {
+  std::weak_ptr<handle_registry_t> registry;
+  std::uintmax_t instance;
+  std::size_t id;
+
+  thread_registration_t(
+      std::weak_ptr<handle_registry_t> registry,
+      std::uintmax_t instance,
+      std::size_t id
+  ) : registry{ std::move(registry) }, instance{ instance }, id{ id } {}
+
+  thread_registration_t(thread_registration_t&& other) noexcept :
+    registry{ std::move(other.registry) }, instance{ other.instance }, id{ other.id } {}
+
+  thread_registration_t& operator=(thread_registration_t&& other) noexcept {
+    std::swap(this->registry, other.registry);
+    std::swap(this->instance, other.instance);
+    std::swap(this->id, other.id);
+    return *this;
+  }
+
+  ~thread_registration_t() noexcept {
+    // the queue may be destroyed concurrently, which the registry checks under its lock
+    if (auto registry = this->registry.lock(); registry != nullptr) {
+      registry->release(this->id);
+    }
+  }
+};
+
+/** The calling thread's registrations with all queues it has used without a thread id. */
+thread_local std::vector<thread_registration_t> thread_registrations{};
+/** The most recently used registration, as a fast path for the common single queue case. */
+thread_local std::uintmax_t cached_instance{ 0 };
+thread_local std::size_t cached_id{ 0 };
+}
+
+std::uintmax_t next_queue_instance() noexcept {
+  return next_instance.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t thread_local_handle(const std::shared_ptr<handle_registry_t>& registry) {
+  const auto instance = registry->instance;
+  if (cached_instance == instance) {
+    return cached_id;
+  }
+
+  auto it = std::find_if(
+      thread_registrations.begin(), thread_registrations.end(),
+      [&](const auto& registration) { return registration.instance == instance; }
+  );
+
+  if (it == thread_registrations.end()) {
+    // drop registrations of queues which have been destroyed in the meantime
+    std::erase_if(thread_registrations, [](const auto& registration) {
+      return registration.registry.expired();
+    });
+
+    const auto id = registry->acquire();
+    it = thread_registrations.emplace(thread_registrations.end(), registry, instance, id);
+  }
+
+  cached_instance = instance;
+  cached_id = it->id;
+  return cached_id;
+}
+}
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/async_queue.hpp"
+#include "ymcqueue/executor.hpp"
+
+namespace {
+/** A fire-and-forget coroutine, which runs eagerly and destroys itself on completion. */
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+using queue_type = ymc::async_queue<int>;
+
+/** Dequeues `count` elements asynchronously and stores them in `out` in dequeue order. */
+detached_task consume(
+    queue_type& queue,
+    ymc::single_thread_executor& executor,
+    std::size_t count,
+    std::vector<int*>& out
+) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out.push_back(co_await queue.async_dequeue(0, executor));
+  }
+}
+
+/** Checks that awaiting consumers complete immediately or are resumed by enqueues in order. */
+bool test_single_thread() {
+  constexpr std::size_t count = 1000;
+  queue_type queue{ 2 };
+  ymc::single_thread_executor executor{};
+  std::vector<int> elements(2 * count);
+  std::vector<int*> out{};
+
+  // the first half is available when awaited, so the coroutine never suspends
+  for (std::size_t i = 0; i < count; ++i) {
+    queue.enqueue(&elements[i], 1);
+  }
+
+  consume(queue, executor, 2 * count, out);
+  if (out.size() != count || executor.poll() != 0) {
+    std::cerr << "awaiting an available element suspended the coroutine" << std::endl;
+    return false;
+  }
+
+  // the second half is enqueued while the coroutine is suspended
+  for (std::size_t i = count; i < 2 * count; ++i) {
+    queue.enqueue(&elements[i], 1);
+    if (executor.poll() != 1 || out.size() != i + 1) {
+      std::cerr << "enqueue did not resume the awaiting coroutine" << std::endl;
+      return false;
+    }
+  }
+
+  for (std::size_t i = 0; i < 2 * count; ++i) {
+    if (out[i] != &elements[i]) {
+      std::cerr << "incorrect element at position " << i << std::endl;
+      return false;
+    }
+  }
+
+  return queue.empty() && executor.poll() == 0;
+}
+
+/** Consumes elements until it receives `stop`, decrementing each element exactly once. */
+template <typename Executor>
+detached_task consume_until(
+    queue_type& queue,
+    Executor& executor,
+    std::size_t thread_id,
+    int* stop,
+    std::atomic_size_t& finished
+) {
+  while (true) {
+    auto elem = co_await queue.async_dequeue(thread_id, executor);
+    if (elem == stop) {
+      break;
+    }
+
+    *elem -= 1;
+  }
+
+  finished.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Resumes posted coroutines right away on the posting thread, i.e., possibly before the awaiting
+ * thread has returned from suspending them.
+ */
+struct inline_executor {
+  void post(std::coroutine_handle<> coro) {
+    coro.resume();
+  }
+};
+
+/** Checks that all elements enqueued by concurrent producers are awaited exactly once. */
+bool test_concurrent() {
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t consumers = 4;
+  constexpr std::size_t count = 50 * 1000;
+
+  queue_type queue{ producers + consumers };
+  ymc::single_thread_executor executors[2]{};
+  std::vector<int> elements(producers * count, 1);
+  int stop = 0;
+  std::atomic_size_t finished{ 0 };
+
+  // two consumers per executor, each running on the executor's thread after its first suspension
+  for (std::size_t c = 0; c < consumers; ++c) {
+    consume_until(queue, executors[c % 2], producers + c, &stop, finished);
+  }
+
+  std::vector<std::thread> runners{};
+  for (auto& executor : executors) {
+    runners.emplace_back([&executor] { executor.run(); });
+  }
+
+  std::vector<std::thread> threads{};
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::size_t i = 0; i < count; ++i) {
+        queue.enqueue(&elements[p * count + i], p);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    queue.enqueue(&stop, 0);
+  }
+
+  while (finished.load(std::memory_order_acquire) < consumers) {
+    std::this_thread::yield();
+  }
+
+  for (auto& executor : executors) {
+    executor.stop();
+  }
+
+  for (auto& runner : runners) {
+    runner.join();
+  }
+
+  for (auto elem : elements) {
+    if (elem != 0) {
+      std::cerr << "element not dequeued exactly once" << std::endl;
+      return false;
+    }
+  }
+
+  return queue.dequeue(0) == nullptr;
+}
+
+/**
+ * Checks that consumers resumed inline by the enqueuers, which immediately await again with the
+ * same thread id, are neither lost nor resumed twice.
+ */
+bool test_inline_resume() {
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t consumers = 4;
+  constexpr std::size_t count = 50 * 1000;
+
+  queue_type queue{ producers + consumers + 1 };
+  inline_executor executor{};
+  std::vector<int> elements(producers * count, 1);
+  int stop = 0;
+  std::atomic_size_t finished{ 0 };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      consume_until(queue, executor, producers + c, &stop, finished);
+    });
+  }
+
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::size_t i = 0; i < count; ++i) {
+        queue.enqueue(&elements[p * count + i], p);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    queue.enqueue(&stop, producers + consumers);
+  }
+
+  if (finished.load(std::memory_order_acquire) != consumers) {
+    std::cerr << "inline resumed consumer lost its wake-up" << std::endl;
+    return false;
+  }
+
+  for (auto elem : elements) {
+    if (elem != 0) {
+      std::cerr << "element not dequeued exactly once with inline resumption" << std::endl;
+      return false;
+    }
+  }
+
+  return queue.dequeue(0) == nullptr;
+}
+}
+
+int main() {
+  if (!test_single_thread()) {
+    return 1;
+  }
+
+  if (!test_concurrent()) {
+    return 1;
+  }
+
+  if (!test_inline_resume()) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
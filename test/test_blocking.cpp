@@ -0,0 +1,80 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+
+int main() {
+  const uint64_t thread_count = 4;
+  const uint64_t count = 50 * 1000;
+
+  std::vector<int> elements{};
+  elements.reserve(count);
+  for (std::uint64_t i = 0; i < count; ++i) {
+    elements.push_back(static_cast<int>(i));
+  }
+
+  ymc::queue<int> queue{ thread_count * 2 };
+
+  // a timed dequeue on an empty queue must time out
+  if (queue.try_dequeue_for(std::chrono::milliseconds{ 10 }, 0) != nullptr) {
+    std::cerr << "timed dequeue on an empty queue returned an element" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::thread> producers{};
+  std::vector<std::thread> consumers{};
+  std::atomic_uint64_t sum{ 0 };
+  std::atomic_uint64_t deq_count{ 0 };
+
+  // consumers are started first and block until elements arrive or the queue is closed
+  for (std::uint64_t thread = 0; thread < thread_count; ++thread) {
+    const auto deq_id = thread + thread_count;
+    consumers.emplace_back([&, deq_id] {
+      uint64_t thread_sum = 0;
+      uint64_t thread_deq_count = 0;
+
+      while (auto res = queue.dequeue_wait(deq_id)) {
+        thread_sum += *res;
+        thread_deq_count += 1;
+      }
+
+      sum.fetch_add(thread_sum);
+      deq_count.fetch_add(thread_deq_count);
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+
+  for (std::uint64_t thread = 0; thread < thread_count; ++thread) {
+    producers.emplace_back([&, thread] {
+      for (auto& elem : elements) {
+        queue.enqueue(&elem, thread);
+      }
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  queue.close();
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  if (deq_count.load() != thread_count * count) {
+    std::cerr << "incorrect element count, got " << deq_count.load() << std::endl;
+    return 1;
+  }
+
+  const auto expected = thread_count * (count * (count - 1) / 2);
+  if (sum.load() != expected) {
+    std::cerr << "incorrect element sum, got " << sum.load() << ", expected " << expected << std::endl;
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+
+/** Destroys a queue before the tokens of its claimed handles, which must not touch it anymore. */
+bool test_token_outlives_queue() {
+  ymc::thread_handle moved{};
+  {
+    auto queue = std::make_unique<ymc::queue<int>>(2);
+    auto handle = queue->acquire_handle();
+    moved = queue->acquire_handle();
+
+    int elem = 0;
+    queue->enqueue(&elem, handle);
+    if (queue->dequeue(moved) != &elem) {
+      std::cerr << "invalid element dequeued through a token" << std::endl;
+      return false;
+    }
+
+    // the queue is destroyed first, `handle` is released afterwards at the end of the scope
+    queue.reset();
+  }
+
+  // releasing a token of a destroyed queue is a no-op
+  moved.reset();
+  return true;
+}
+
+int main() {
+  const uint64_t max_threads = 4;
+  const uint64_t rounds = 8;
+  const uint64_t count = 10 * 1000;
+
+  std::vector<int> elements{};
+  elements.reserve(count);
+  for (std::uint64_t i = 0; i < count; ++i) {
+    elements.push_back(static_cast<int>(i));
+  }
+
+  ymc::queue<int> queue{ max_threads };
+  std::atomic_uint64_t sum{ 0 };
+
+  // more threads than handles over the queue's lifetime, each pair of threads claims and releases
+  // its handles, half of them through explicit tokens, the other half thread-locally
+  for (std::uint64_t round = 0; round < rounds; ++round) {
+    std::thread producer{ [&, round] {
+      if (round % 2 == 0) {
+        auto handle = queue.acquire_handle();
+        for (auto& elem : elements) {
+          queue.enqueue(&elem, handle);
+        }
+      } else {
+        for (auto& elem : elements) {
+          queue.enqueue(&elem);
+        }
+      }
+    } };
+
+    std::thread consumer{ [&, round] {
+      auto handle = queue.acquire_handle();
+      uint64_t thread_sum = 0;
+      uint64_t deq_count = 0;
+
+      while (deq_count < count) {
+        const auto res = round % 2 == 0 ? queue.dequeue(handle) : queue.dequeue();
+        if (res != nullptr) {
+          thread_sum += *res;
+          deq_count += 1;
+        }
+      }
+
+      sum.fetch_add(thread_sum);
+    } };
+
+    producer.join();
+    consumer.join();
+  }
+
+  // all handles must have been released again
+  std::vector<ymc::thread_handle> handles{};
+  for (std::uint64_t i = 0; i < max_threads; ++i) {
+    handles.push_back(queue.acquire_handle());
+  }
+
+  if (queue.dequeue(handles[0]) != nullptr) {
+    std::cerr << "queue not empty after all dequeue operations" << std::endl;
+    return 1;
+  }
+
+  const auto expected = rounds * (count * (count - 1) / 2);
+  if (sum.load() != expected) {
+    std::cerr << "incorrect element sum, got " << sum.load() << ", expected " << expected << std::endl;
+    return 1;
+  }
+
+  if (!test_token_outlives_queue()) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
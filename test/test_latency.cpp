@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+
+/** Checks the log-linear bucketing, percentiles and merging of latency histograms. */
+bool test_histogram() {
+  ymc::latency_histogram low{};
+  ymc::latency_histogram high{};
+
+  for (std::uint64_t i = 1; i <= 1000; ++i) {
+    low.record(i);
+  }
+  high.record(1 << 20);
+
+  // bucket upper bounds are within 1/16 of the exact percentile
+  const auto p50 = low.percentile(0.5);
+  if (p50 < 500 || p50 > 500 + 500 / 16) {
+    std::cerr << "invalid p50: " << p50 << std::endl;
+    return false;
+  }
+
+  low.merge(high);
+  const auto summary = low.summary();
+  if (summary.count != 1001 || summary.max != (1 << 20) || summary.p999 < 990) {
+    std::cerr << "invalid merged summary" << std::endl;
+    return false;
+  }
+
+  return ymc::latency_histogram{}.percentile(0.99) == 0;
+}
+
+/** Checks that every operation is recorded in exactly one histogram, if latencies are enabled. */
+bool test_queue() {
+  const auto count = 10 * 1000;
+
+  std::vector<int> storage(count);
+  ymc::queue<int> queue{ 1 };
+  for (auto& elem : storage) {
+    queue.enqueue(&elem, 0);
+  }
+  for (auto i = 0; i < count; ++i) {
+    queue.dequeue(0);
+  }
+
+  const auto latencies = queue.latencies();
+  const auto enqueues = latencies.fast_enqueue.count() + latencies.slow_enqueue.count();
+  const auto dequeues = latencies.fast_dequeue.count() + latencies.slow_dequeue.count();
+
+  if (latencies.enabled) {
+    return enqueues == count && dequeues == count;
+  }
+
+  return enqueues == 0 && dequeues == 0;
+}
+
+/** Checks that latency histograms are only allocated for the handles that record operations. */
+bool test_footprint() {
+  int elem = 0;
+  ymc::queue<int> queue{ 128 };
+  const auto initial = queue.memory_footprint();
+
+  queue.enqueue(&elem, 0);
+  const auto histograms = queue.memory_footprint() - initial;
+
+  if (queue.latencies().enabled) {
+    return histograms == sizeof(ymc::detail::handle_latencies_t);
+  }
+
+  return histograms == 0;
+}
+
+int main() {
+  if (!test_histogram()) {
+    return 1;
+  }
+
+  if (!test_queue()) {
+    std::cerr << "invalid queue latency histograms" << std::endl;
+    return 1;
+  }
+
+  if (!test_footprint()) {
+    std::cerr << "latency histograms allocated for unused handles" << std::endl;
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/queue.hpp"
+
+namespace {
+template <typename Mode, typename Backoff, std::size_t Patience>
+using mode_queue = ymc::basic_queue<
+    int, 1024, Patience, 128, ymc::padded_cells, ymc::hazard_reclaim, Mode, Backoff
+>;
+
+constexpr std::size_t COUNT = 100 * 1000;
+
+/**
+ * Runs `producers` producers enqueueing `COUNT` elements each and `consumers` consumers, checks
+ * that every element is dequeued exactly once and that each consumer observes the elements of
+ * every producer in order.
+ */
+template <typename Mode, typename Backoff = ymc::no_backoff, std::size_t Patience = 10>
+bool test_mode(const char* name, std::size_t producers, std::size_t consumers) {
+  mode_queue<Mode, Backoff, Patience> queue{ producers + consumers };
+  std::vector<std::vector<int>> elements(producers, std::vector<int>(COUNT));
+  for (auto& producer : elements) {
+    for (std::size_t i = 0; i < COUNT; ++i) {
+      producer[i] = static_cast<int>(i);
+    }
+  }
+
+  std::atomic_size_t dequeued{ 0 };
+  std::atomic_bool failed{ false };
+  std::vector<std::thread> threads{};
+
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (auto& elem : elements[p]) {
+        queue.enqueue(&elem, p);
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      std::vector<int> next(producers, 0);
+      while (dequeued.load(std::memory_order_relaxed) < producers * COUNT) {
+        const auto res = queue.dequeue(producers + c);
+        if (res == nullptr) {
+          continue;
+        }
+
+        // elements are identified by their address, values are only unique per producer
+        std::size_t p = 0;
+        while (res < elements[p].data() || res >= elements[p].data() + COUNT) {
+          ++p;
+        }
+
+        if (*res < next[p]) {
+          failed.store(true);
+        }
+
+        next[p] = *res + 1;
+        *res = -1;
+        dequeued.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (failed.load()) {
+    std::cerr << name << ": elements of a producer were dequeued out of order" << std::endl;
+    return false;
+  }
+
+  for (const auto& producer : elements) {
+    for (auto elem : producer) {
+      if (elem != -1) {
+        std::cerr << name << ": element not dequeued" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  if (queue.dequeue(producers) != nullptr) {
+    std::cerr << name << ": queue not empty after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main() {
+  if (!test_mode<ymc::spsc>("spsc", 1, 1)) {
+    return 1;
+  }
+
+  if (!test_mode<ymc::mpsc>("mpsc", 4, 1)) {
+    return 1;
+  }
+
+  // a single consumer which exhausts its patience after one attempt walks the cells itself
+  if (!test_mode<ymc::mpsc, ymc::no_backoff, 1>("mpsc_slow", 4, 1)) {
+    return 1;
+  }
+
+  if (!test_mode<ymc::spmc>("spmc", 1, 4)) {
+    return 1;
+  }
+
+  // backoff only changes how long dequeuers wait before poisoning cells, not the order
+  if (!test_mode<ymc::mpmc, ymc::fixed_backoff<64>>("mpmc_fixed_backoff", 4, 4)) {
+    return 1;
+  }
+
+  if (!test_mode<ymc::mpmc, ymc::adaptive_backoff<256>>("mpmc_adaptive_backoff", 4, 4)) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <iostream>
+#include <span>
 #include <thread>
 #include <vector>
 
 #include "ymcqueue/queue.hpp"
 
-int main() {
+/**
+ * Runs `thread_count` producers and consumers on a queue of type `Q` and checks that the sum of
+ * all dequeued elements matches the sum of all enqueued ones.
+ */
+template <typename Q>
+bool test_sum(const char* name) {
   const uint64_t thread_count = 8;
   const uint64_t count = 100 * 1000;
 
@@ -27,7 +35,7 @@ int main() {
   std::atomic_bool start{ false };
   std::atomic_uint64_t sum{ 0 };
 
-  ymc::queue<int> queue{ thread_count * 2 };
+  Q queue{ thread_count * 2 };
 
   for (auto thread = 0; thread < thread_count; ++thread) {
     // producer thread
@@ -66,14 +74,143 @@ int main() {
   }
 
   if (queue.dequeue(0) != nullptr) {
-    std::cerr << "queue not empty after count * threads dequeue operations" << std::endl;
-    return 1;
+    std::cerr << name << ": queue not empty after count * threads dequeue operations" << std::endl;
+    return false;
   }
 
   const auto res = sum.load();
   const auto expected = thread_count * (count * (count - 1) / 2);
   if (res != expected) {
-    std::cerr << "incorrect element sum, got " << sum << ", expected " << expected << std::endl;
+    std::cerr << name << ": incorrect element sum, got " << sum << ", expected " << expected
+              << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Runs producers enqueueing their elements in batches of varying size and consumers dequeueing
+ * them either one by one or in batches, while consumers polling the empty queue poison cells of
+ * reserved batches. Checks that every element is dequeued exactly once and that each consumer
+ * observes the elements of every producer in order.
+ */
+bool test_bulk() {
+  const std::size_t producers = 4;
+  const std::size_t consumers = 4;
+  const std::size_t count = 100 * 1000;
+
+  std::vector<std::vector<int>> elements(producers, std::vector<int>(count));
+  for (auto& producer : elements) {
+    for (std::size_t i = 0; i < count; ++i) {
+      producer[i] = static_cast<int>(i);
+    }
+  }
+
+  std::atomic_bool start{ false };
+  std::atomic_bool failed{ false };
+  std::atomic_size_t dequeued{ 0 };
+  std::vector<std::thread> threads{};
+
+  ymc::queue<int> queue{ producers + consumers };
+
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      std::vector<int*> ptrs{};
+      for (auto& elem : elements[p]) {
+        ptrs.push_back(&elem);
+      }
+
+      while (!start.load()) {}
+
+      // batches of 1 to 64 elements, which regularly cross node boundaries
+      for (std::size_t i = 0, batch = 1; i < count; i += batch, batch = batch % 64 + 1) {
+        batch = std::min(batch, count - i);
+        queue.enqueue_bulk(std::span{ ptrs }.subspan(i, batch), p);
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      std::vector<int> next(producers, 0);
+      std::array<int*, 32> out{};
+      // every other consumer dequeues in batches, mixed with the ones dequeueing one by one
+      const bool bulk = c % 2 == 1;
+
+      while (!start.load()) {}
+
+      while (dequeued.load(std::memory_order_relaxed) < producers * count) {
+        std::size_t n = 0;
+        if (bulk) {
+          n = queue.dequeue_bulk(out.data(), out.size(), producers + c);
+        } else if ((out[0] = queue.dequeue(producers + c)) != nullptr) {
+          n = 1;
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+          const auto res = out[i];
+
+          // elements are identified by their address, values are only unique per producer
+          std::size_t p = 0;
+          while (res < elements[p].data() || res >= elements[p].data() + count) {
+            ++p;
+          }
+
+          // dequeued elements are marked, so duplicates are detected as well
+          if (*res < next[p]) {
+            failed.store(true);
+          }
+
+          next[p] = *res + 1;
+          *res = -1;
+        }
+
+        dequeued.fetch_add(n, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  start.store(true);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (failed.load()) {
+    std::cerr << "bulk: elements of a producer were dequeued out of order or twice" << std::endl;
+    return false;
+  }
+
+  for (const auto& producer : elements) {
+    for (auto elem : producer) {
+      if (elem != -1) {
+        std::cerr << "bulk: element not dequeued" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  if (queue.dequeue(0) != nullptr) {
+    std::cerr << "bulk: queue not empty after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int main() {
+  if (!test_sum<ymc::queue<int>>("hazard")) {
+    return 1;
+  }
+
+  // small nodes and frequent cleanup retire nodes while peers are still helping on them
+  using epoch_queue = ymc::basic_queue<int, 16, 10, 16, ymc::padded_cells, ymc::epoch_reclaim>;
+  if (!test_sum<epoch_queue>("epoch")) {
+    return 1;
+  }
+
+  if (!test_bulk()) {
     return 1;
   }
 
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/priority_queue.hpp"
+
+namespace {
+/** Checks that elements are dequeued by priority first and in FIFO order within each lane. */
+bool test_order() {
+  constexpr std::size_t count = 3000;
+  ymc::priority_queue<int, 4> queue{ 1 };
+  std::vector<int> elements(4 * count);
+
+  // interleave the levels, so the order is only restored by the lanes
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t level = 4; level-- > 0;) {
+      queue.enqueue(&elements[level * count + i], level, 0);
+    }
+  }
+
+  for (std::size_t expected = 0; expected < 4 * count; ++expected) {
+    std::size_t level = 0;
+    const auto res = queue.dequeue(0, level);
+    if (res != &elements[expected] || level != expected / count) {
+      std::cerr << "incorrect element at position " << expected << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.dequeue(0) != nullptr || !queue.empty()) {
+    std::cerr << "queue not empty after all elements were dequeued" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** Checks that all elements enqueued by concurrent producers are dequeued exactly once. */
+bool test_concurrent() {
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t consumers = 4;
+  constexpr std::size_t count = 50 * 1000;
+
+  ymc::priority_queue<int, 8> queue{ producers + consumers };
+  std::vector<int> elements(producers * count, 1);
+  std::atomic_size_t dequeued{ 0 };
+  std::vector<std::thread> threads{};
+
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::size_t i = 0; i < count; ++i) {
+        queue.enqueue(&elements[p * count + i], (p + i) % 8, p);
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      while (dequeued.load(std::memory_order_relaxed) < producers * count) {
+        if (auto res = queue.dequeue(producers + c); res != nullptr) {
+          *res -= 1;
+          dequeued.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto elem : elements) {
+    if (elem != 0) {
+      std::cerr << "element not dequeued exactly once" << std::endl;
+      return false;
+    }
+  }
+
+  return queue.dequeue(0) == nullptr;
+}
+}
+
+int main() {
+  if (!test_order()) {
+    return 1;
+  }
+
+  if (!test_concurrent()) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
@@ -0,0 +1,128 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/select.hpp"
+
+namespace {
+using queue_type = ymc::queue<int>;
+
+/** Checks that earlier queues take priority and that polling empty queues claims no cells. */
+bool test_order() {
+  std::array<queue_type, 3> queues{ queue_type{ 1 }, queue_type{ 1 }, queue_type{ 1 } };
+  ymc::select<queue_type> select{ { &queues[0], 0 }, { &queues[1], 0 }, { &queues[2], 0 } };
+  int a = 0, b = 1, c = 2;
+
+  for (auto i = 0; i < 10 * 1000; ++i) {
+    if (select.try_dequeue()) {
+      std::cerr << "select on empty queues returned an element" << std::endl;
+      return false;
+    }
+  }
+
+#if YMC_QUEUE_STATS
+  for (const auto& queue : queues) {
+    const auto stats = queue.stats();
+    if (stats.fast_dequeues + stats.slow_dequeues != 0 || stats.cells_burned != 0) {
+      std::cerr << "polling empty queues claimed cells" << std::endl;
+      return false;
+    }
+  }
+#endif
+
+  queues[2].enqueue(&c, 0);
+  queues[1].enqueue(&b, 0);
+  queues[0].enqueue(&a, 0);
+
+  for (std::size_t expected = 0; expected < 3; ++expected) {
+    const auto res = select.try_dequeue();
+    if (!res || res.index != expected || *res.elem != static_cast<int>(expected)) {
+      std::cerr << "select did not prefer earlier queues" << std::endl;
+      return false;
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  if (select.try_dequeue_for(std::chrono::milliseconds(5))) {
+    std::cerr << "timed select on empty queues returned an element" << std::endl;
+    return false;
+  }
+
+  return std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5);
+}
+
+/**
+ * Checks that a parked select is woken up by enqueues into any of its queues and that every
+ * element is dequeued exactly once.
+ */
+bool test_wait() {
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t count = 20 * 1000;
+
+  std::vector<std::unique_ptr<queue_type>> queues{};
+  std::vector<ymc::select_source<queue_type>> sources{};
+  for (std::size_t p = 0; p < producers; ++p) {
+    queues.push_back(std::make_unique<queue_type>(2));
+    sources.push_back({ queues.back().get(), 1 });
+  }
+
+  std::vector<int> elements(producers * count, 1);
+  std::atomic_size_t dequeued{ 0 };
+
+  std::thread consumer{ [&] {
+    ymc::select<queue_type> select{ sources };
+    while (auto res = select.dequeue_wait()) {
+      *res.elem -= 1;
+      dequeued.fetch_add(1, std::memory_order_relaxed);
+    }
+  } };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::size_t i = 0; i < count; ++i) {
+        queues[p]->enqueue(&elements[p * count + i], 0);
+        // let the consumer park every now and then
+        if (i % 1000 == 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& queue : queues) {
+    queue->close();
+  }
+
+  consumer.join();
+
+  for (auto elem : elements) {
+    if (elem != 0) {
+      std::cerr << "element not dequeued exactly once" << std::endl;
+      return false;
+    }
+  }
+
+  return dequeued.load() == producers * count;
+}
+}
+
+int main() {
+  if (!test_order()) {
+    return 1;
+  }
+
+  if (!test_wait()) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
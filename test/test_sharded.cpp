@@ -0,0 +1,105 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/sharded_queue.hpp"
+
+namespace {
+struct element_t {
+  std::size_t producer;
+  std::size_t seq;
+};
+
+/**
+ * Runs producers bound to distinct shards and consumers all bound to the first shard, so most
+ * elements are stolen, and checks that all elements are dequeued exactly once and that each
+ * consumer observes the elements of every producer in order.
+ */
+bool test_relaxed_fifo(ymc::steal_policy steal, ymc::node_memory memory) {
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t consumers = 4;
+  constexpr std::size_t count = 50 * 1000;
+
+  ymc::sharded_queue<element_t> queue{ producers + consumers, 4, steal, memory };
+  if (queue.shard_count() < 4) {
+    std::cerr << "expected at least 4 shards, got " << queue.shard_count() << std::endl;
+    return false;
+  }
+
+  std::vector<std::vector<element_t>> elements(producers);
+  for (std::size_t p = 0; p < producers; ++p) {
+    queue.bind(p, p);
+    for (std::size_t i = 0; i < count; ++i) {
+      elements[p].push_back({ p, i });
+    }
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    queue.bind(producers + c, 0);
+  }
+
+  std::atomic_size_t dequeued{ 0 };
+  std::atomic_bool failed{ false };
+  std::vector<std::thread> threads{};
+
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (auto& elem : elements[p]) {
+        queue.enqueue(&elem, p);
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c] {
+      std::vector<std::size_t> next(producers, 0);
+      while (dequeued.load(std::memory_order_relaxed) < producers * count) {
+        const auto elem = queue.dequeue(producers + c);
+        if (elem == nullptr) {
+          continue;
+        }
+
+        if (elem->seq < next[elem->producer]) {
+          failed.store(true);
+        }
+
+        next[elem->producer] = elem->seq + 1;
+        dequeued.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (failed.load()) {
+    std::cerr << "elements of a producer were dequeued out of order" << std::endl;
+    return false;
+  }
+
+  if (dequeued.load() != producers * count || !queue.empty() || queue.dequeue(0) != nullptr) {
+    std::cerr << "incorrect number of dequeued elements: " << dequeued.load() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main() {
+  if (!test_relaxed_fifo(ymc::steal_policy::round_robin, ymc::node_memory::huge_pages)) {
+    return 1;
+  }
+
+  if (!test_relaxed_fifo(ymc::steal_policy::two_choices, ymc::node_memory::huge_pages)) {
+    return 1;
+  }
+
+  if (!test_relaxed_fifo(ymc::steal_policy::two_choices, ymc::node_memory::heap)) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
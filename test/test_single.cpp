@@ -1,18 +1,16 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <span>
+#include <thread>
 #include <vector>
 
-#include "ymcqueue/erased_queue.hpp"
+#include "ymcqueue/queue.hpp"
 
-int main() {
-  const auto count = 10 * 1000;
-
-  std::vector<int> storage{};
-  storage.reserve(count);
-  for (auto i = 0; i < count; ++i) {
-    storage.push_back(i);
-  }
-
-  ymc::queue<int> queue{ 1 };
+/** Enqueues all elements of `storage` and dequeues them again in FIFO order. */
+template <typename Q>
+bool test_fifo(Q& queue, std::vector<int>& storage) {
+  const auto count = storage.size();
 
   for (auto& elem : storage) {
     queue.enqueue(&elem, 0);
@@ -22,20 +20,422 @@ int main() {
     auto res = queue.dequeue(0);
     if (res == nullptr) {
       std::cerr << "missing elements: " << i << "/" << count << std::endl;
-      return 1;
+      return false;
     }
 
     if (*res != i) {
       std::cerr << "invalid element: " << *res << ", expected " << i << std::endl;
-      return 1;
+      return false;
     }
   }
 
   if (queue.dequeue(0) != nullptr) {
     std::cerr << "too many elements in queue" << std::endl;
+    return false;
   }
 
-  std::cout << "test successful" << std::endl;
+  return true;
+}
+
+/** Enqueues and dequeues all elements of `storage` in batches in FIFO order. */
+bool test_fifo_bulk(ymc::queue<int>& queue, std::vector<int>& storage) {
+  const auto count = storage.size();
+  const auto batch = std::size_t{ 100 };
+
+  std::vector<int*> ptrs{};
+  for (auto& elem : storage) {
+    ptrs.push_back(&elem);
+  }
+
+  for (std::size_t i = 0; i < count; i += batch) {
+    queue.enqueue_bulk(std::span{ ptrs }.subspan(i, std::min(batch, count - i)), 0);
+  }
+
+  std::vector<int*> out(batch);
+  for (std::size_t i = 0; i < count;) {
+    const auto n = queue.dequeue_bulk(out.data(), out.size(), 0);
+    if (n == 0) {
+      std::cerr << "missing elements after bulk dequeue: " << i << "/" << count << std::endl;
+      return false;
+    }
+
+    for (std::size_t j = 0; j < n; ++j, ++i) {
+      if (static_cast<std::size_t>(*out[j]) != i) {
+        std::cerr << "invalid element: " << *out[j] << ", expected " << i << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // polling an empty queue in bulk must neither claim cells nor allocate nodes
+  const auto misses = queue.pool_stats().misses;
+  for (auto i = 0; i < 1000; ++i) {
+    if (queue.dequeue_bulk(out.data(), out.size(), 0) != 0) {
+      std::cerr << "bulk dequeue on an empty queue returned elements" << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.size_approx() != 0 || queue.pool_stats().misses != misses) {
+    std::cerr << "bulk polling an empty queue claimed cells" << std::endl;
+    return false;
+  }
+
+#if YMC_QUEUE_STATS
+  // an enqueue after polling finds an unclaimed cell on its fast path
+  const auto slow_enqueues = queue.stats().slow_enqueues;
+  queue.enqueue(&storage[0], 0);
+  if (queue.stats().slow_enqueues != slow_enqueues || queue.dequeue(0) != &storage[0]) {
+    std::cerr << "bulk polling an empty queue poisoned cells" << std::endl;
+    return false;
+  }
+#endif
+
+  return true;
+}
+
+/**
+ * Fills a bounded queue up to its capacity in several rounds and checks that all nodes are
+ * recycled from the preallocated pool.
+ */
+bool test_bounded(std::vector<int>& storage) {
+  const auto capacity = storage.size() / 2;
+  ymc::queue<int> queue{ 1, ymc::capacity{ capacity } };
+
+  for (auto round = 0; round < 8; ++round) {
+    std::size_t count = 0;
+    while (queue.try_enqueue(&storage[count], 0)) {
+      count += 1;
+    }
+
+    if (count != capacity) {
+      std::cerr << "bounded queue accepted " << count << " elements" << std::endl;
+      return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (queue.dequeue(0) != &storage[i]) {
+        std::cerr << "invalid element in bounded queue" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  if (queue.pool_stats().misses != 0) {
+    std::cerr << "bounded queue allocated nodes beyond its pool" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Fills and drains a small bounded queue with the given reclamation policy in many rounds, so its
+ * head advances far beyond the reclamation threshold, and checks that every round accepts the full
+ * capacity, waiting for a background reclaimer if necessary.
+ */
+template <typename Reclaim>
+bool test_bounded_reclaim(const char* name, std::vector<int>& storage) {
+  const auto capacity = std::size_t{ 100 };
+  ymc::basic_queue<int, 16, 10, 1, ymc::padded_cells, Reclaim> queue{
+      1, ymc::capacity{ capacity }
+  };
+
+  for (auto round = 0; round < 64; ++round) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 1 };
+    std::size_t count = 0;
+    while (count < capacity && std::chrono::steady_clock::now() < deadline) {
+      if (queue.try_enqueue(&storage[count], 0)) {
+        count += 1;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+
+    if (count != capacity || queue.try_enqueue(&storage[count], 0)) {
+      std::cerr << name << ": bounded queue accepted " << count << " elements in round " << round
+                << std::endl;
+      return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (queue.dequeue(0) != &storage[i]) {
+        std::cerr << name << ": invalid element in bounded queue" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return queue.pool_stats().misses == 0;
+}
+
+/**
+ * Passes elements from a producer to a consumer handle of a bounded queue and polls it while
+ * empty, checking that its memory footprint never grows beyond the preallocated nodes.
+ */
+bool test_bounded_footprint(std::vector<int>& storage) {
+  const auto capacity = storage.size() / 4;
+  ymc::queue<int> queue{ 2, ymc::capacity{ capacity } };
+  // both handles allocate their latency histograms on their first operation, if enabled
+  const auto histograms =
+      queue.latencies().enabled ? 2 * sizeof(ymc::detail::handle_latencies_t) : 0;
+  const auto footprint = queue.memory_footprint() + histograms;
+
+  for (auto round = 0; round < 16; ++round) {
+    std::size_t count = 0;
+    while (queue.try_enqueue(&storage[count], 0)) {
+      count += 1;
+    }
+
+    if (count != capacity) {
+      std::cerr << "bounded queue accepted " << count << " elements" << std::endl;
+      return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (queue.dequeue(1) != &storage[i]) {
+        std::cerr << "invalid element in bounded queue" << std::endl;
+        return false;
+      }
+    }
+
+    // dequeues from the empty queue must neither claim cells nor acquire nodes
+    for (auto i = 0; i < 100 * 1000; ++i) {
+      if (queue.dequeue(1) != nullptr) {
+        std::cerr << "dequeue on an empty bounded queue returned an element" << std::endl;
+        return false;
+      }
+    }
+
+    if (queue.memory_footprint() != footprint) {
+      std::cerr << "bounded queue footprint grew to " << queue.memory_footprint() << " bytes"
+                << std::endl;
+      return false;
+    }
+  }
+
+#if YMC_QUEUE_STATS
+  // no cells were poisoned, so all enqueues completed on the fast path
+  if (queue.stats().slow_enqueues != 0) {
+    std::cerr << "dequeues from an empty bounded queue poisoned cells" << std::endl;
+    return false;
+  }
+#endif
+
+  return queue.pool_stats().misses == 0;
 }
 
+/** Polls an empty queue and checks that polling neither claims cells nor allocates nodes. */
+bool test_try_dequeue(std::vector<int>& storage) {
+  ymc::queue<int> queue{ 1 };
 
+  for (auto i = 0; i < 100 * 1000; ++i) {
+    if (queue.try_dequeue(0) != nullptr) {
+      std::cerr << "try_dequeue on an empty queue returned an element" << std::endl;
+      return false;
+    }
+  }
+
+  if (!queue.empty() || queue.size_approx() != 0 || queue.pool_stats().misses != 0) {
+    std::cerr << "polling an empty queue claimed cells" << std::endl;
+    return false;
+  }
+
+  queue.enqueue(&storage[0], 0);
+  queue.enqueue(&storage[1], 0);
+  if (queue.empty() || queue.size_approx() != 2) {
+    std::cerr << "invalid queue size" << std::endl;
+    return false;
+  }
+
+  return queue.try_dequeue(0) == &storage[0] && queue.try_dequeue(0) == &storage[1]
+      && queue.try_dequeue(0) == nullptr;
+}
+
+/**
+ * Keeps a backlog spanning many nodes while an otherwise idle handle, whose pointers are only
+ * advanced by cleanup, enqueues in between, so its lookups skip ahead through the node directory.
+ */
+bool test_lagging_handle(std::vector<int>& storage) {
+  ymc::basic_queue<int, 16, 10, 2> queue{ 2 };
+  const auto backlog = storage.size() / 2;
+  std::size_t next_enq = 0;
+  std::size_t next_deq = 0;
+
+  for (; next_enq < backlog; ++next_enq) {
+    queue.enqueue(&storage[next_enq], 0);
+  }
+
+  while (next_enq < storage.size()) {
+    for (auto op = 0; op < 100 && next_enq < storage.size(); ++op) {
+      queue.enqueue(&storage[next_enq++], op % 10 == 0 ? 1 : 0);
+      if (queue.dequeue(0) != &storage[next_deq++]) {
+        std::cerr << "invalid element with lagging handle at " << next_deq - 1 << std::endl;
+        return false;
+      }
+    }
+  }
+
+  for (; next_deq < storage.size(); ++next_deq) {
+    if (queue.dequeue(1) != &storage[next_deq]) {
+      std::cerr << "invalid element while draining at " << next_deq << std::endl;
+      return false;
+    }
+  }
+
+  return queue.dequeue(1) == nullptr;
+}
+
+/** Checks that spare nodes are only acquired by handles in use and counted in the footprint. */
+bool test_footprint(std::vector<int>& storage) {
+  using queue_type = ymc::queue<int>;
+  queue_type queue{ 128 };
+
+  // only the head node is allocated on construction, not one spare node per handle
+  const auto initial = queue.memory_footprint();
+  if (initial >= 2 * queue_type::NODE_BYTES) {
+    std::cerr << "unused handles hold spare nodes" << std::endl;
+    return false;
+  }
+
+  queue.enqueue(&storage[0], 0);
+  if (queue.dequeue(0) != &storage[0]) {
+    std::cerr << "invalid element" << std::endl;
+    return false;
+  }
+
+  // the dequeuing handle has acquired its spare node and, if enabled, its latency histograms
+  const auto histograms = queue.latencies().enabled ? sizeof(ymc::detail::handle_latencies_t) : 0;
+  if (queue.memory_footprint() != initial + queue_type::NODE_BYTES + histograms) {
+    std::cerr << "spare node of a used handle not counted in the footprint" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int main() {
+  const auto count = 10 * 1000;
+
+  std::vector<int> storage{};
+  storage.reserve(count);
+  for (auto i = 0; i < count; ++i) {
+    storage.push_back(i);
+  }
+
+  ymc::queue<int> queue{ 1 };
+  if (!test_fifo(queue, storage)) {
+    return 1;
+  }
+
+#if YMC_QUEUE_STATS
+  const auto stats = queue.stats();
+  if (
+      stats.fast_enqueues + stats.slow_enqueues != count
+      || stats.fast_dequeues + stats.slow_dequeues != count + 1
+      || stats.node_bytes == 0 || stats.spare_bytes == 0
+  ) {
+    std::cerr << "invalid queue statistics" << std::endl;
+    return 1;
+  }
+#endif
+
+  ymc::queue<int> bulk_queue{ 1 };
+  if (!test_fifo_bulk(bulk_queue, storage)) {
+    return 1;
+  }
+
+  ymc::queue<int> prepared_queue{ 1, 16 };
+  prepared_queue.start_node_preparer(8);
+  if (!test_fifo(prepared_queue, storage)) {
+    return 1;
+  }
+
+  ymc::queue<int> huge_page_queue{ 1, 2, ymc::node_memory::huge_pages };
+  if (!test_fifo(huge_page_queue, storage)) {
+    return 1;
+  }
+
+  // the footprint counts the regions holding the nodes, not just the nodes themselves
+  if (huge_page_queue.memory_footprint() < ymc::detail::node_arena_t::REGION_SIZE) {
+    std::cerr << "huge page regions not counted in the footprint" << std::endl;
+    return 1;
+  }
+
+  // a node size that is no power of two and a patience that forces the slow path more often
+  ymc::basic_queue<int, 1000, 2, 4> small_queue{ 1 };
+  if (!test_fifo(small_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<int, 1024, 10, 1, ymc::split_cells> split_queue{ 1 };
+  if (!test_fifo(split_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<int, 1024, 10, 1, ymc::dense_cells> dense_queue{ 1 };
+  if (!test_fifo(dense_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<int, 1000, 10, 1, ymc::dense_cells> dense_non_pow2_queue{ 1 };
+  if (!test_fifo(dense_non_pow2_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<int, 1024, 10, 1, ymc::padded_cells, ymc::eager_reclaim<1>> eager_queue{ 1 };
+  if (!test_fifo(eager_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<
+      int, 1024, 10, 1, ymc::padded_cells, ymc::background_hazard_reclaim<20>
+  > background_queue{ 1 };
+  if (!test_fifo(background_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<int, 16, 10, 1, ymc::padded_cells, ymc::epoch_reclaim> epoch_queue{ 1 };
+  if (!test_fifo(epoch_queue, storage)) {
+    return 1;
+  }
+
+  ymc::basic_queue<
+      int, 1024, 10, 1, ymc::padded_cells, ymc::hazard_reclaim, ymc::mpmc, ymc::adaptive_backoff<64>
+  > backoff_queue{ 1 };
+  if (!test_fifo(backoff_queue, storage)) {
+    return 1;
+  }
+
+  if (!test_bounded(storage)) {
+    return 1;
+  }
+
+  if (!test_bounded_footprint(storage)) {
+    return 1;
+  }
+
+  if (
+      !test_bounded_reclaim<ymc::hazard_reclaim>("hazard", storage)
+      || !test_bounded_reclaim<ymc::eager_reclaim<1>>("eager_1", storage)
+      || !test_bounded_reclaim<ymc::eager_reclaim<64>>("eager_64", storage)
+      || !test_bounded_reclaim<ymc::background_hazard_reclaim<20>>("background", storage)
+      || !test_bounded_reclaim<ymc::epoch_reclaim>("epoch", storage)
+  ) {
+    return 1;
+  }
+
+  if (!test_try_dequeue(storage)) {
+    return 1;
+  }
+
+  if (!test_lagging_handle(storage)) {
+    return 1;
+  }
+
+  if (!test_footprint(storage)) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}
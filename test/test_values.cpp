@@ -0,0 +1,135 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ymcqueue/value_queue.hpp"
+
+/** A small trivially copyable type, which is stored inline. */
+struct pair_t {
+  std::int16_t first;
+  std::int16_t second;
+};
+
+/** Enqueues and dequeues values in FIFO order, including zero and the largest valid value. */
+bool test_fifo() {
+  ymc::value_queue<std::uint64_t> queue{ 1 };
+  const auto max = std::numeric_limits<std::uint64_t>::max() - 2;
+
+  queue.enqueue(0, 0);
+  queue.enqueue(max, 0);
+  for (std::uint64_t i = 1; i < 1000; ++i) {
+    queue.enqueue(i, 0);
+  }
+
+  if (queue.dequeue(0) != 0 || queue.dequeue(0) != max) {
+    std::cerr << "invalid boundary values" << std::endl;
+    return false;
+  }
+
+  for (std::uint64_t i = 1; i < 1000; ++i) {
+    const auto res = queue.dequeue(0);
+    if (res != i) {
+      std::cerr << "invalid value, expected " << i << std::endl;
+      return false;
+    }
+  }
+
+  if (queue.dequeue(0).has_value()) {
+    std::cerr << "too many values in queue" << std::endl;
+    return false;
+  }
+
+  try {
+    queue.enqueue(std::numeric_limits<std::uint64_t>::max(), 0);
+    std::cerr << "reserved value was accepted" << std::endl;
+    return false;
+  } catch (const std::invalid_argument&) {}
+
+  ymc::value_queue<pair_t> pair_queue{ 1 };
+  pair_queue.enqueue(pair_t{ -1, 7 }, 0);
+  const auto pair = pair_queue.dequeue(0);
+  if (!pair.has_value() || pair->first != -1 || pair->second != 7) {
+    std::cerr << "invalid pair value" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** Enqueues and dequeues values in batches in FIFO order. */
+bool test_fifo_bulk() {
+  ymc::value_queue<int> queue{ 1 };
+  const auto count = 1000;
+
+  std::vector<int> values{};
+  for (auto i = 0; i < count; ++i) {
+    values.push_back(i);
+  }
+
+  queue.enqueue_bulk(values, 0);
+
+  std::vector<int> out(count);
+  if (queue.dequeue_bulk(out.data(), out.size(), 0) != count || out != values) {
+    std::cerr << "invalid bulk dequeue" << std::endl;
+    return false;
+  }
+
+  return queue.dequeue_bulk(out.data(), out.size(), 0) == 0;
+}
+
+/** Transports values from multiple producers to multiple consumers without any storage. */
+bool test_multi() {
+  const uint64_t thread_count = 4;
+  const uint64_t count = 50 * 1000;
+
+  ymc::value_queue<std::uint64_t> queue{ thread_count * 2 };
+  std::vector<std::thread> threads{};
+  std::atomic_uint64_t sum{ 0 };
+
+  for (std::uint64_t thread = 0; thread < thread_count; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (std::uint64_t i = 0; i < count; ++i) {
+        queue.enqueue(i, thread);
+      }
+    });
+
+    const auto deq_id = thread + thread_count;
+    threads.emplace_back([&, deq_id] {
+      uint64_t thread_sum = 0;
+      uint64_t deq_count = 0;
+
+      while (deq_count < count) {
+        if (const auto res = queue.dequeue(deq_id)) {
+          thread_sum += *res;
+          deq_count += 1;
+        }
+      }
+
+      sum.fetch_add(thread_sum);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto expected = thread_count * (count * (count - 1) / 2);
+  if (sum.load() != expected) {
+    std::cerr << "incorrect value sum, got " << sum << ", expected " << expected << std::endl;
+    return false;
+  }
+
+  return !queue.dequeue(0).has_value();
+}
+
+int main() {
+  if (!test_fifo() || !test_fifo_bulk() || !test_multi()) {
+    return 1;
+  }
+
+  std::cout << "test successful" << std::endl;
+}